@@ -13,7 +13,6 @@
 
 /*
  TO DO
- - Logic for handling macro assignments
  - Adding augmented data to main data tree
  - GUI
  */
@@ -27,26 +26,34 @@ int main (int argc, char* argv[])
     TT_Augmenter augmenter(&fetcher);
     augmenter.setMode(Mode::NOISE);
     augmenter.fetchSpectralData();
-    augmenter.augmentSpectralTags();
     augmenter.fetchTemporalData();
-    augmenter.augmentTemporalTags();
     
-    TT_Formatter formatter (&augmenter);
-    formatter.formatSpectralData();
-    formatter.scrambleSpectralData();
-    formatter.formatTemporalData();
-    formatter.scrambleTemporalData();
+    // augmented samples are generated batch by batch during training, only the cleaned originals are kept,
+    // each tag gets the augmenter's planned count, see setTargetRowsPerTag / setRowBudget
+    TT_AugmentingBatchSource spectralSource (augmenter.getSpectralTags(), TT_Formatter::getSpectralLabels(), augmenter.getMode(),
+                                             augmenter.planAugmentation(augmenter.getSpectralTags()), augmenter.getSpectralNoise(), augmenter.getNumNeighbours());
+    TT_AugmentingBatchSource temporalSource (augmenter.getTemporalTags(), TT_Formatter::getTemporalLabels(), augmenter.getMode(),
+                                             augmenter.planAugmentation(augmenter.getTemporalTags()), augmenter.getTemporalNoise(), augmenter.getNumNeighbours());
     
-    ParameterData spectralData = formatter.getSpectralData();
-    ParameterData temporalData = formatter.getTemporalData();
+    // original vs augmented distributions of everything the models are trained on
+    TT_Statistics statistics;
+    spectralSource.setStatistics(&statistics, DataNodes::TypeNodes::Spectral.toString(), DataNodes::TagNodes::Spectral::Patch::patchTags);
+    temporalSource.setStatistics(&statistics, DataNodes::TypeNodes::Temporal.toString(), DataNodes::TagNodes::Temporal::Patch::patchTags);
     
     TT_Spectral spectralModel;
     spectralModel.construct();
-    spectralModel.train(spectralData.data, spectralData.labels);
+    spectralModel.train(spectralSource);
 
     TT_Temporal temporalModel;
     temporalModel.construct();
-    temporalModel.train(temporalData.data, temporalData.labels);
+    temporalModel.train(temporalSource);
+    
+    statistics.logSummary();
+    
+    const juce::File reportFile = juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+                                      .getChildFile("TT").getChildFile("AugmentationReport.json");
+    if(reportFile.getParentDirectory().createDirectory().failed() || !statistics.writeReport(reportFile, Parallel::defaultNumThreads()))
+        DBG("Failed to write augmentation report to " << reportFile.getFullPathName());
     
     return 0;
 }
@@ -0,0 +1,93 @@
+/*
+  ==============================================================================
+
+    TT_AugmentPlan.h
+    Created: 21 Oct 2026 2:41:07pm
+    Author:  Matt Twitchen
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include <vector>
+
+/*
+ How many augmented rows each tag gets.
+
+ Every plan takes the number of cleaned originals per tag and returns the number of
+ rows to generate for it, originals not included. A tag with no originals can't be
+ augmented and always gets 0.
+
+ - forScaleFactor: the old behaviour, every tag grows by the same factor
+ - forTarget:      every tag is topped up to the same number of rows, tags already at
+                   or above it get nothing
+ - forBudget:      a total row count for the whole type is shared out so the smallest
+                   tags are raised first (water filling), each tag ends up with either
+                   its originals or a common level, whichever is larger
+ */
+
+namespace AugmentPlan
+{
+    static inline std::vector<int> forScaleFactor(const std::vector<int>& numOriginals, int scaleFactor)
+    {
+        std::vector<int> numAugmented (numOriginals.size());
+        for(size_t i = 0 ; i < numOriginals.size() ; i++)
+            numAugmented[i] = numOriginals[i] * juce::jmax(0, scaleFactor);
+        
+        return numAugmented;
+    }
+    
+    static inline std::vector<int> forTarget(const std::vector<int>& numOriginals, int targetRows)
+    {
+        std::vector<int> numAugmented (numOriginals.size());
+        for(size_t i = 0 ; i < numOriginals.size() ; i++)
+            numAugmented[i] = numOriginals[i] > 0 ? juce::jmax(0, targetRows - numOriginals[i]) : 0;
+        
+        return numAugmented;
+    }
+    
+    static inline std::vector<int> forBudget(const std::vector<int>& numOriginals, int totalRows)
+    {
+        auto rowsAtLevel = [&] (juce::int64 level)
+        {
+            juce::int64 total = 0;
+            for(int n : numOriginals)
+                total += n > 0 ? juce::jmax((juce::int64)n, level) : 0;
+            return total;
+        };
+        
+        // highest level the budget covers
+        juce::int64 low = 0;
+        juce::int64 high = juce::jmax(0, totalRows);
+        while(low < high)
+        {
+            const juce::int64 mid = (low + high + 1) / 2;
+            if(rowsAtLevel(mid) <= totalRows)
+                low = mid;
+            else
+                high = mid - 1;
+        }
+        
+        std::vector<int> numAugmented = forTarget(numOriginals, (int)low);
+        
+        // whatever is left is less than one row per tag at the level, handed out in tag order
+        juce::int64 remaining = totalRows - rowsAtLevel(low);
+        for(size_t i = 0 ; i < numOriginals.size() && remaining > 0 ; i++)
+        {
+            if(numOriginals[i] > 0 && numOriginals[i] <= low)
+            {
+                numAugmented[i]++;
+                remaining--;
+            }
+        }
+        
+        return numAugmented;
+    }
+    
+    // source row of the ith of numRows rows spread evenly over numSource rows
+    static inline int getSourceRow(int i, int numRows, int numSource)
+    {
+        return (int)((juce::int64)i * numSource / numRows);
+    }
+}
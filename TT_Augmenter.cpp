@@ -12,6 +12,7 @@
 
 #define spectralParams DataNodes::ParameterNodes::spectralParams
 #define temporalParams DataNodes::ParameterNodes::temporalParams
+#define firstTemporalFeature DataNodes::ParameterNodes::firstTemporalFeature
 
 #define spectralChild DataNodes::TagNodes::Spectral::Patch::patchTags
 #define temporalChild DataNodes::TagNodes::Temporal::Patch::patchTags
@@ -23,675 +24,396 @@ TT_Augmenter::TT_Augmenter(TT_Fetcher* ttf)
 {
     fetcher = ttf;
     jassert(fetcher->getState());
-    
-    dataTree = fetcher->getDataTree();
-    jassert(dataTree != nullptr);
-    
-    spectralTree = dataTree->getChildWithName(DataNodes::TypeNodes::Spectral);
-    temporalTree = dataTree->getChildWithName(DataNodes::TypeNodes::Temporal);
 }
 
 TT_Augmenter::~TT_Augmenter()
 {
     fetcher = nullptr;
-    dataTree = nullptr;
 }
 
 void TT_Augmenter::fetchSpectralData()
 {
-    jassert(spectralTree.isValid());
+    const TT_PatchStore& store = fetcher->getSpectralStore();
+    jassert(store.getNumRows() > 0);
     
-    fetchBrightData();
-    fetchDarkData();
-    fetchResonantData();
-    fetchSoftData();
+    for(int tag = 0 ; tag < spectralChild.size() ; tag++)
+        cleanTag(store, tag, Cleaning::Spectral::rules[tag], 0, spectralDataset, spectralTags);
 }
 
-void TT_Augmenter::fetchBrightData()
+void TT_Augmenter::fetchTemporalData()
 {
-    juce::ValueTree brightParent = spectralTree.getChildWithName(DataNodes::TagNodes::Spectral::Parents::BrightParent);
-    
-    float avgFilterFrequencyBright = 0;
-    for(int i = 0 ; i < brightParent.getNumChildren() ; i++)
-    {
-        juce::ValueTree child = brightParent.getChild(i);
-        avgFilterFrequencyBright += (float)child.getProperty(spectralParams[0]);
-    }
-    avgFilterFrequencyBright /= brightParent.getNumChildren();
-    
-    TagVector bright;
-    std::vector<float> brightMags;
-    for(int i = 0 ; i < brightParent.getNumChildren() ; i++)
-    {
-        juce::ValueTree child = brightParent.getChild(i);
-        PATCH patch;
-        
-        if((float)child.getProperty(spectralParams[0]) <= Thresholds::Spectral::Bright::filterFrequency)
-            child.setProperty(spectralParams[0], avgFilterFrequencyBright, nullptr);
-        
-        for(int j = 0 ; j < spectralParams.size() ; j++)
-        {
-            patch.push_back(child.getProperty(spectralParams[j]));
-        }
-        
-        bright.push_back(patch);
-        brightMags.push_back(calculateMagnitude(patch));
-    }
-    
-    sortTagVector(bright);
-    sortMagVector(brightMags);
+    const TT_PatchStore& store = fetcher->getTemporalStore();
+    jassert(store.getNumRows() > 0);
     
-    spectralTags.push_back(bright);
-    spectralMags.push_back(brightMags);
+    // env type is only read by the rules, patches start at the first feature
+    for(int tag = 0 ; tag < temporalChild.size() ; tag++)
+        cleanTag(store, tag, Cleaning::Temporal::rules[tag], firstTemporalFeature, temporalDataset, temporalTags);
 }
 
-void TT_Augmenter::fetchDarkData()
+void TT_Augmenter::cleanTag(const TT_PatchStore& store, int tag, const Cleaning::TagRules& rules, int firstFeature,
+                            TT_PatchStore& dataset, std::vector<PatchMatrix>& tags)
 {
-    juce::ValueTree darkParent = spectralTree.getChildWithName(DataNodes::TagNodes::Spectral::Parents::DarkParent);
-    
-    float avgFilterFrequencyDark = 0;
-    for(int i = 0 ; i < darkParent.getNumChildren() ; i++)
-    {
-        juce::ValueTree child = darkParent.getChild(i);
-        avgFilterFrequencyDark += (float)child.getProperty(spectralParams[0]);
-    }
-    avgFilterFrequencyDark /= darkParent.getNumChildren();
+    std::vector<int> rows = store.getRowsWithTag(tag);
+    const int numRows = (int)rows.size();
+    const int numParams = store.getNumParams();
     
-    TagVector dark;
-    std::vector<float> darkMags;
-    for(int i = 0 ; i < darkParent.getNumChildren() ; i++)
+    // gather the tag's rows into contiguous columns, this is the only pass over the store
+    std::vector<float> block ((size_t)(numParams * numRows));
+    for(int k = 0 ; k < numParams ; k++)
     {
-        juce::ValueTree child = darkParent.getChild(i);
-        PATCH patch;
-        
-        if((float)child.getProperty(spectralParams[0]) <= Thresholds::Spectral::Dark::filterFrequency)
-            child.setProperty(spectralParams[0], avgFilterFrequencyDark, nullptr);
-        
-        for(int j = 0 ; j < spectralParams.size() ; j++)
-        {
-            patch.push_back(child.getProperty(spectralParams[j]));
-        }
-        
-        dark.push_back(patch);
-        darkMags.push_back(calculateMagnitude(patch));
+        const float* source = store.getColumn(k);
+        float* column = block.data() + (size_t)(k * numRows);
+        for(int i = 0 ; i < numRows ; i++)
+            column[i] = source[rows[(size_t)i]];
     }
     
-    sortTagVector(dark);
-    sortMagVector(darkMags);
-    
-    spectralTags.push_back(dark);
-    spectralMags.push_back(darkMags);
-}
-
-void TT_Augmenter::fetchResonantData()
-{
-    juce::ValueTree resonantParent = spectralTree.getChildWithName(DataNodes::TagNodes::Spectral::Parents::ResonantParent);
-    
-    float avgFilterEmphasisReso = 0;
-    for(int i = 0 ; i < resonantParent.getNumChildren() ; i++)
+    // every mean is taken before any replacement
+    float means[Cleaning::maxRules] = {};
+    for(int r = 0 ; r < rules.numRules && numRows > 0 ; r++)
     {
-        juce::ValueTree child = resonantParent.getChild(i);
-        avgFilterEmphasisReso += (float)child.getProperty(spectralParams[1]);
+        const float* column = block.data() + (size_t)(rules.rules[r].param * numRows);
+        float sum = 0;
+        for(int i = 0 ; i < numRows ; i++)
+            sum += column[i];
+        means[r] = sum / numRows;
     }
-    avgFilterEmphasisReso /= resonantParent.getNumChildren();
     
-    TagVector resonant;
-    std::vector<float> resoMags;
-    for(int i = 0 ; i < resonantParent.getNumChildren() ; i++)
+    for(int r = 0 ; r < rules.numRules ; r++)
     {
-        juce::ValueTree child = resonantParent.getChild(i);
-        PATCH patch;
-        
-        if((float)child.getProperty(spectralParams[1]) <= Thresholds::Spectral::Resonant::filterEmphasis)
-            child.setProperty(spectralParams[1], avgFilterEmphasisReso, nullptr);
+        const Cleaning::Rule& rule = rules.rules[r];
+        float* column = block.data() + (size_t)(rule.param * numRows);
+        const float threshold = rule.threshold;
+        const float mean = means[r];
         
-        for(int j = 0 ; j < spectralParams.size() ; j++)
+        // branch free selects so the loops vectorise
+        if(rule.direction == Cleaning::Below)
+        {
+            for(int i = 0 ; i < numRows ; i++)
+                column[i] = column[i] <= threshold ? mean : column[i];
+        } else
         {
-            patch.push_back(child.getProperty(spectralParams[j]));
+            for(int i = 0 ; i < numRows ; i++)
+                column[i] = column[i] >= threshold ? mean : column[i];
         }
-
-        resonant.push_back(patch);
-        resoMags.push_back(calculateMagnitude(patch));
     }
     
-    sortTagVector(resonant);
-    sortMagVector(resoMags);
-    
-    spectralTags.push_back(resonant);
-    spectralMags.push_back(resoMags);
-}
-
-void TT_Augmenter::fetchSoftData()
-{
-    juce::ValueTree softParent = spectralTree.getChildWithName(DataNodes::TagNodes::Spectral::Parents::SoftParent);
-    
-    float avgFilterFrequency = 0;
-    for(int i = 0 ; i < softParent.getNumChildren() ; i++)
+    if(rules.clearGateReleases)
     {
-        juce::ValueTree child = softParent.getChild(i);
-        avgFilterFrequency += (float)child.getProperty(spectralParams[0]);
+        const float* envType = block.data() + (size_t)(Cleaning::Temporal::envType * numRows);
+        for(int param : Cleaning::Temporal::releaseParams)
+        {
+            float* column = block.data() + (size_t)(param * numRows);
+            for(int i = 0 ; i < numRows ; i++)
+                column[i] = envType[i] == 0.f ? 0.f : column[i];
+        }
     }
-    avgFilterFrequency /= softParent.getNumChildren();
     
-    float avgFilterEmphasis = 0;
-    for(int i = 0 ; i < softParent.getNumChildren() ; i++)
-    {
-        juce::ValueTree child = softParent.getChild(i);
-        avgFilterEmphasis += (float)child.getProperty(spectralParams[1]);
-    }
-    avgFilterEmphasis /= softParent.getNumChildren();
+    // the feature columns are already contiguous, every magnitude comes out of one pass over them
+    std::vector<float> patchMags ((size_t)numRows);
+    Magnitude::ofColumns(block.data() + (size_t)(firstFeature * numRows), numRows, numParams - firstFeature, patchMags.data());
+    
+    PatchMatrix patches (numRows, numParams - firstFeature);
+    dataset.reserve(dataset.getNumRows() + numRows);
     
-    TagVector soft;
-    std::vector<float> softMags;
-    for(int i = 0 ; i < softParent.getNumChildren() ; i++)
+    for(int i = 0 ; i < numRows ; i++)
     {
-        juce::ValueTree child = softParent.getChild(i);
-        PATCH patch;
-        
-        if((float)child.getProperty(spectralParams[0]) <= Thresholds::Spectral::Soft::filterFrequency)
-            child.setProperty(spectralParams[0], avgFilterFrequency, nullptr);
+        Span<float> patch = patches.getRow(i);
+        for(int k = firstFeature ; k < numParams ; k++)
+            patch[(size_t)(k - firstFeature)] = block[(size_t)(k * numRows + i)];
         
-        if((float)child.getProperty(spectralParams[1]) <= Thresholds::Spectral::Soft::filterEmphasis)
-            child.setProperty(spectralParams[1], avgFilterEmphasis, nullptr);
-        
-        for(int j = 0 ; j < spectralParams.size() ; j++)
-        {
-            patch.push_back(child.getProperty(spectralParams[j]));
-        }
-
-        soft.push_back(patch);
-        softMags.push_back(calculateMagnitude(patch));
+        dataset.addRow(patch.data(), TT_PatchStore::tagBit(tag), store.getSourceFile(rows[(size_t)i]));
     }
     
-    sortTagVector(soft);
-    sortMagVector(softMags);
+    // the interpolators walk each tag from its largest to its smallest patch
+    Magnitude::sortDescending(patches, patchMags);
     
-    spectralTags.push_back(soft);
-    spectralMags.push_back(softMags);
+    tags.push_back(std::move(patches));
 }
 
-void TT_Augmenter::fetchTemporalData()
+void TT_Augmenter::augmentTags()
 {
-    jassert(temporalTree.isValid());
-    
-    fetchPluckData();
-    fetchLongReleaseData();
-    fetchSwellData();
-    fetchShortData();
+    runAugmentTasks(true, true);
 }
 
-void TT_Augmenter::fetchPluckData()
+void TT_Augmenter::augmentSpectralTags()
 {
-    juce::ValueTree pluckParent = temporalTree.getChildWithName(DataNodes::TagNodes::Temporal::Parents::PluckParent);
-    
-    float avgFilterAttack = 0;
-    for(int i = 0 ; i < pluckParent.getNumChildren() ; i++)
-    {
-        juce::ValueTree child = pluckParent.getChild(i);
-        avgFilterAttack += (float)child.getProperty(temporalParams[1]);
-    }
-    avgFilterAttack /= pluckParent.getNumChildren();
+    runAugmentTasks(true, false);
+}
+
+void TT_Augmenter::augmentTemporalTags()
+{
+    runAugmentTasks(false, true);
+}
+
+std::vector<int> TT_Augmenter::planAugmentation(const std::vector<PatchMatrix>& tags) const
+{
+    std::vector<int> numOriginals;
+    for(auto& patches : tags)
+        numOriginals.push_back(patches.getNumRows());
     
-    float avgVcaAttack = 0;
-    for(int i = 0 ; i < pluckParent.getNumChildren() ; i++)
-    {
-        juce::ValueTree child = pluckParent.getChild(i);
-        avgVcaAttack += (float)child.getProperty(temporalParams[5]);
-    }
-    avgVcaAttack /= pluckParent.getNumChildren();
+    if(targetRowsPerTag > 0)
+        return AugmentPlan::forTarget(numOriginals, targetRowsPerTag);
     
-    TagVector pluck;
-    std::vector<float> pluckMags;
-    for(int i = 0 ; i < pluckParent.getNumChildren() ; i++)
-    {
-        juce::ValueTree child = pluckParent.getChild(i);
-        PATCH patch;
-        
-        if((float)child.getProperty(temporalParams[1]) >= Thresholds::Temporal::Pluck::filterAttack)
-            child.setProperty(temporalParams[1], avgFilterAttack, nullptr);
-        
-        if((float)child.getProperty(temporalParams[5]) >= Thresholds::Temporal::Pluck::vcaAttack)
-            child.setProperty(temporalParams[5], avgVcaAttack, nullptr);
-        
-        for(int j = 1 ; j < temporalParams.size() ; j++) // start at 1 to miss env type
-        {
-            patch.push_back(child.getProperty(temporalParams[j]));
-        }
-        
-        if((float)child.getProperty(temporalParams[0]) == 0.f)
-        {
-            patch.at(5) = 0.f; // filter release
-            patch.at(8) = 0.f; // vca release
-        }
-        
-        child.removeProperty(temporalParams[0], nullptr);
-        pluck.push_back(patch);
-        pluckMags.push_back(calculateMagnitude(patch));
-    }
+    if(rowBudget > 0)
+        return AugmentPlan::forBudget(numOriginals, rowBudget);
     
-    sortTagVector(pluck);
-    sortMagVector(pluckMags);
-    
-    temporalTags.push_back(pluck);
-    temporalMags.push_back(pluckMags);
+    return AugmentPlan::forScaleFactor(numOriginals, scaleFactor);
 }
 
-void TT_Augmenter::fetchLongReleaseData()
+void TT_Augmenter::runAugmentTasks(bool spectral, bool temporal)
 {
-    juce::ValueTree longReleaseParent = temporalTree.getChildWithName(DataNodes::TagNodes::Temporal::Parents::LongReleaseParent);
-    
-    float avgFilterRelease = 0;
-    for(int i = 0 ; i < longReleaseParent.getNumChildren() ; i++)
-    {
-        juce::ValueTree child = longReleaseParent.getChild(i);
-        avgFilterRelease += (float)child.getProperty(temporalParams[4]);
-    }
-    avgFilterRelease /= longReleaseParent.getNumChildren();
+    PatchMatrix::resetNumAllocations();
     
-    float avgVcaRelease = 0;
-    for(int i = 0 ; i < longReleaseParent.getNumChildren() ; i++)
+    // every replica of a tag shares one neighbour search
+    std::vector<std::vector<int>> neighbours[2];
+    if(mode == SMOTE)
     {
-        juce::ValueTree child = longReleaseParent.getChild(i);
-        avgVcaRelease += (float)child.getProperty(temporalParams[8]);
+        for(int type = 0 ; type < 2 ; type++)
+        {
+            const bool isTemporal = type == 1;
+            if(isTemporal ? !temporal : !spectral)
+                continue;
+            
+            for(auto& patches : isTemporal ? temporalTags : spectralTags)
+            {
+                TT_KdTree tree (patches);
+                neighbours[type].push_back(tree.findNeighboursOfPoints(numNeighbours, numThreads));
+            }
+        }
     }
-    avgVcaRelease /= longReleaseParent.getNumChildren();
     
-    TagVector longRelease;
-    std::vector<float> longReleaseMags;
-    for(int i = 0 ; i < longReleaseParent.getNumChildren() ; i++)
+    std::vector<AugmentTask> tasks;
+    for(int type = 0 ; type < 2 ; type++)
     {
-        juce::ValueTree child = longReleaseParent.getChild(i);
-        PATCH patch;
-        
-        if((float)child.getProperty(temporalParams[4]) <= Thresholds::Temporal::LongRelease::filterRelease)
-            child.setProperty(temporalParams[4], avgFilterRelease, nullptr);
+        const bool isTemporal = type == 1;
+        if(isTemporal ? !temporal : !spectral)
+            continue;
         
-        if((float)child.getProperty(temporalParams[8]) <= Thresholds::Temporal::LongRelease::vcaRelease)
-            child.setProperty(temporalParams[8], avgVcaRelease, nullptr);
+        const std::vector<PatchMatrix>& tags = isTemporal ? temporalTags : spectralTags;
+        const std::vector<int> plan = planAugmentation(tags);
         
-        for(int j = 1 ; j < temporalParams.size() ; j++) // start at 1 to miss env type
+        // an interpolator makes all of a tag's rows in one pass, noise and SMOTE get a task per pass over the originals
+        int maxReplicas = 0;
+        for(size_t tag = 0 ; tag < tags.size() ; tag++)
         {
-            patch.push_back(child.getProperty(temporalParams[j]));
+            DBG((isTemporal ? temporalChild : spectralChild)[(int)tag].toString() << ": " << tags[tag].getNumRows()
+                << " originals, " << plan[tag] << " planned");
+            
+            if(mode != INTERP && tags[tag].getNumRows() > 0)
+                maxReplicas = juce::jmax(maxReplicas, (plan[tag] + tags[tag].getNumRows() - 1) / tags[tag].getNumRows());
         }
         
-        child.removeProperty(temporalParams[0], nullptr);
-        longRelease.push_back(patch);
-        longReleaseMags.push_back(calculateMagnitude(patch));
+        if(mode == INTERP)
+            maxReplicas = 1;
+        
+        for(int replica = 0 ; replica < maxReplicas ; replica++)
+        {
+            for(int tag = 0 ; tag < (int)tags.size() ; tag++)
+            {
+                const int numOriginals = tags[(size_t)tag].getNumRows();
+                const int numRows = mode == INTERP ? plan[(size_t)tag] : juce::jmin(numOriginals, plan[(size_t)tag] - replica * numOriginals);
+                if(numRows <= 0)
+                    continue;
+                
+                AugmentTask task;
+                task.isTemporal = isTemporal;
+                task.tag = tag;
+                task.replica = replica;
+                task.numRows = numRows;
+                if(mode == SMOTE)
+                    task.neighbours = &neighbours[type][(size_t)tag];
+                tasks.push_back(std::move(task));
+            }
+        }
     }
     
-    sortTagVector(longRelease);
-    sortMagVector(longReleaseMags);
+    Parallel::forEachTask((int)tasks.size(), numThreads, [&] (int i)
+    {
+        tasks[(size_t)i].result = augmentTag(tasks[(size_t)i]);
+    });
     
-    temporalTags.push_back(longRelease);
-    temporalMags.push_back(longReleaseMags);
-}
-
-void TT_Augmenter::fetchSwellData()
-{
-    juce::ValueTree swellParent = temporalTree.getChildWithName(DataNodes::TagNodes::Temporal::Parents::SwellParent);
+    numAllocations = PatchMatrix::getNumAllocations();
     
-    float avgFilterAttack = 0;
-    for(int i = 0 ; i < swellParent.getNumChildren() ; i++)
+    statistics.reset();
+    if(spectral)
     {
-        juce::ValueTree child = swellParent.getChild(i);
-        avgFilterAttack += (float)child.getProperty(temporalParams[1]);
+        for(int tag = 0 ; tag < (int)spectralTags.size() ; tag++)
+            statistics.addOriginal("Spectral " + spectralChild[tag].toString(), spectralTags[(size_t)tag]);
     }
-    avgFilterAttack /= swellParent.getNumChildren();
-    
-    float avgVcaAttack = 0;
-    for(int i = 0 ; i < swellParent.getNumChildren() ; i++)
+    if(temporal)
     {
-        juce::ValueTree child = swellParent.getChild(i);
-        avgVcaAttack += (float)child.getProperty(temporalParams[5]);
+        for(int tag = 0 ; tag < (int)temporalTags.size() ; tag++)
+            statistics.addOriginal("Temporal " + temporalChild[tag].toString(), temporalTags[(size_t)tag]);
     }
-    avgVcaAttack /= swellParent.getNumChildren();
     
-    TagVector swell;
-    std::vector<float> swellMags;
-    for(int i = 0 ; i < swellParent.getNumChildren() ; i++)
+    // one reservation per dataset for every row the tasks made
+    int numAugmentedRows[2] = {0, 0};
+    for(auto& task : tasks)
+        numAugmentedRows[task.isTemporal ? 1 : 0] += task.result.getNumRows();
+    
+    spectralDataset.reserve(spectralDataset.getNumRows() + numAugmentedRows[0]);
+    temporalDataset.reserve(temporalDataset.getNumRows() + numAugmentedRows[1]);
+    
+    // merged in task order so the datasets don't depend on how the tasks were scheduled
+    for(auto& task : tasks)
     {
-        juce::ValueTree child = swellParent.getChild(i);
-        PATCH patch;
-        
-        if((float)child.getProperty(temporalParams[1]) <= Thresholds::Temporal::Swell::filterAttack)
-            child.setProperty(temporalParams[1], avgFilterAttack, nullptr);
-        
-        if((float)child.getProperty(temporalParams[5]) <= Thresholds::Temporal::Swell::vcaAttack)
-            child.setProperty(temporalParams[5], avgVcaAttack, nullptr);
-        
-        for(int j = 1 ; j < temporalParams.size() ; j++) // start at 1 to miss env type
+        if(task.isTemporal)
         {
-            patch.push_back(child.getProperty(temporalParams[j]));
-        }
-        
-        if((float)child.getProperty(temporalParams[0]) == 0.f)
+            statistics.addAugmented("Temporal " + temporalChild[task.tag].toString(), task.result);
+            addAugmentedTemporalTags(task.result, task.tag);
+        } else
         {
-            patch.at(5) = 0.f; // filter release
-            patch.at(8) = 0.f; // vca release
+            statistics.addAugmented("Spectral " + spectralChild[task.tag].toString(), task.result);
+            addAugmentedSpectralTags(task.result, task.tag);
         }
-        
-        child.removeProperty(temporalParams[0], nullptr);
-        swell.push_back(patch);
-        swellMags.push_back(calculateMagnitude(patch));
     }
     
-    sortTagVector(swell);
-    sortMagVector(swellMags);
-    
-    temporalTags.push_back(swell);
-    temporalMags.push_back(swellMags);
+    statistics.logSummary();
+    DBG("Augmented " << (int)tasks.size() << " tasks with " << numAllocations << " patch buffer allocations");
 }
 
-void TT_Augmenter::fetchShortData()
+PatchMatrix TT_Augmenter::augmentTag(const AugmentTask& task) const
 {
-    juce::ValueTree shortParent = temporalTree.getChildWithName(DataNodes::TagNodes::Temporal::Parents::ShortParent);
+    const size_t tag = (size_t)task.tag;
     
-    float avgVcaAttack = 0;
-    for(int i = 0 ; i < shortParent.getNumChildren() ; i++)
-    {
-        juce::ValueTree child = shortParent.getChild(i);
-        avgVcaAttack += (float)child.getProperty(temporalParams[5]);
-    }
-    avgVcaAttack /= shortParent.getNumChildren();
+    // interpolation only makes rows strictly between neighbouring originals, it overshoots with the smallest
+    // whole factor per segment that covers the plan, then thins out evenly
+    const int numSegments = juce::jmax(1, (task.isTemporal ? temporalTags : spectralTags)[tag].getNumRows() - 1);
+    const int factor = juce::jmax(1, (task.numRows + numSegments - 1) / numSegments);
     
-    float avgVcaSustain = 0;
-    for(int i = 0 ; i < shortParent.getNumChildren() ; i++)
+    // every task gets its own interpolator, they keep per call state
+    if(mode == INTERP && task.isTemporal)
     {
-        juce::ValueTree child = shortParent.getChild(i);
-        avgVcaSustain += (float)child.getProperty(temporalParams[7]);
+        TT_TemporalInterpolator interpolator (interpolationKind);
+        return selectRows(interpolator.interpolateTag(temporalTags[tag], factor), task.numRows);
     }
-    avgVcaSustain /= shortParent.getNumChildren();
     
-    TagVector shortPatches;
-    std::vector<float> shortMags;
-    for(int i = 0 ; i < shortParent.getNumChildren() ; i++)
+    if(mode == INTERP)
     {
-        juce::ValueTree child = shortParent.getChild(i);
-        PATCH patch;
-        
-        if((float)child.getProperty(temporalParams[5]) >= Thresholds::Temporal::Short::vcaAttack)
-            child.setProperty(temporalParams[5], avgVcaAttack, nullptr);
-        if((float)child.getProperty(temporalParams[7]) >= Thresholds::Temporal::Short::vcaSustain)
-            child.setProperty(temporalParams[7], avgVcaSustain, nullptr);
-        
-        for(int j = 1 ; j < temporalParams.size() ; j++) // start at 1 to miss env type
-        {
-            patch.push_back(child.getProperty(temporalParams[j]));
-        }
-        
-        if((float)child.getProperty(temporalParams[0]) == 0.f)
-        {
-            patch.at(5) = 0.f; // filter release
-            patch.at(8) = 0.f; // vca release
-        }
-        
-        child.removeProperty(temporalParams[0], nullptr);
-        shortPatches.push_back(patch);
-        shortMags.push_back(calculateMagnitude(patch));
+        TT_SpectralInterpolator interpolator (interpolationKind);
+        return selectRows(interpolator.interpolateTag(spectralTags[tag], factor), task.numRows);
     }
     
-    sortTagVector(shortPatches);
-    sortMagVector(shortMags);
+    if(mode == SMOTE && task.isTemporal)
+        return synthesise(temporalTags[tag], *task.neighbours, temporalNoise, task.tag, task.replica, task.numRows);
     
-    temporalTags.push_back(shortPatches);
-    temporalMags.push_back(shortMags);
-}
-
-void TT_Augmenter::augmentSpectralTags()
-{
-    if(mode == INTERP)
-        interpolateSpectralTags();
-    else if(mode == NOISE)
-        injectNoiseSpectralTags();
-}
-
-void TT_Augmenter::augmentTemporalTags()
-{
-    if(mode == INTERP)
-        interpolateTemporalTags();
-    else if(mode == NOISE)
-        injectNoiseTemporalTags();
-}
-
-void TT_Augmenter::interpolateSpectralTags()
-{
-    TagVector bright = spectralInterpolator.interpolateTag(spectralTags[0], spectralMags[0], scaleFactor);
-    TagVector dark = spectralInterpolator.interpolateTag(spectralTags[1], spectralMags[1], scaleFactor);
-    TagVector resonant = spectralInterpolator.interpolateTag(spectralTags[2], spectralMags[2], scaleFactor);
-    TagVector soft = spectralInterpolator.interpolateTag(spectralTags[3], spectralMags[3], scaleFactor);
-    
-    DBG("===== Bright Error =====");
-    errorCheck(spectralTags[0], bright);
-    DBG("===== Dark Error =====");
-    errorCheck(spectralTags[1], dark);
-    DBG("===== Resonant Error =====");
-    errorCheck(spectralTags[2], resonant);
-    DBG("===== Soft Error =====");
-    errorCheck(spectralTags[3], soft);
-    
-    addAugmentedSpectralTags(bright, spectralParents[0], spectralChild[0]);
-    addAugmentedSpectralTags(dark, spectralParents[1], spectralChild[1]);
-    addAugmentedSpectralTags(resonant, spectralParents[2], spectralChild[2]);
-    addAugmentedSpectralTags(soft, spectralParents[3], spectralChild[3]);
+    if(mode == SMOTE)
+        return synthesise(spectralTags[tag], *task.neighbours, spectralNoise, task.tag, task.replica, task.numRows);
+    
+    if(task.isTemporal)
+        return addNoise(temporalTags[tag], temporalNoise, task.tag, task.replica, task.numRows);
+    
+    return addNoise(spectralTags[tag], spectralNoise, task.tag, task.replica, task.numRows);
 }
 
-void TT_Augmenter::interpolateTemporalTags()
+PatchMatrix TT_Augmenter::selectRows(PatchMatrix rows, int numRows)
 {
-    TagVector pluck = temporalInterpolator.interpolateTag(temporalTags[0], temporalMags[0], scaleFactor);
-    TagVector longRelease = temporalInterpolator.interpolateTag(temporalTags[1], temporalMags[1], scaleFactor);
-    TagVector swell = temporalInterpolator.interpolateTag(temporalTags[2], temporalMags[2], scaleFactor);
-    TagVector shortTag = temporalInterpolator.interpolateTag(temporalTags[3], temporalMags[3], scaleFactor);
-    
-    DBG("===== Pluck Error =====");
-    errorCheck(temporalTags[0], pluck);
-    DBG("===== Long Release Error =====");
-    errorCheck(temporalTags[1], longRelease);
-    DBG("===== Swell Error =====");
-    errorCheck(temporalTags[2], swell);
-    DBG("===== Short Error =====");
-    errorCheck(temporalTags[3], shortTag);
-    
-    addAugmentedTemporalTags(pluck, temporalParents[0], temporalChild[0]);
-    addAugmentedTemporalTags(longRelease, temporalParents[1], temporalChild[1]);
-    addAugmentedTemporalTags(swell, temporalParents[2], temporalChild[2]);
-    addAugmentedTemporalTags(shortTag, temporalParents[3], temporalChild[3]);
+    if(rows.getNumRows() <= numRows)
+        return rows;
+    
+    PatchMatrix selected (numRows, rows.getNumParams());
+    for(int i = 0 ; i < numRows ; i++)
+    {
+        Span<const float> row = rows.getRow(AugmentPlan::getSourceRow(i, numRows, rows.getNumRows()));
+        std::copy(row.begin(), row.end(), selected.getRow(i).begin());
+    }
+    
+    return selected;
 }
 
-void TT_Augmenter::injectNoiseSpectralTags()
+PatchMatrix TT_Augmenter::addNoise(PatchView patches, const TT_NoiseEngine& noise, int tag, int replica, int numRows) const
 {
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_real_distribution<double> distribution(-0.15, 0.15);
+    const int numSource = patches.getNumRows();
+    const int numParams = noise.getNumParams();
+    jassert(patches.getNumParams() == numParams);
+    jassert(numRows <= numSource);
+    
+    // noise is generated a whole parameter column at a time
+    std::vector<float> column ((size_t)numRows);
+    PatchMatrix noisy (numRows, numParams);
     
-    for(int i = 0 ; i < scaleFactor ; i++)
+    for(int k = 0 ; k < numParams ; k++)
     {
-        TagVector bright = spectralTags[0];
-        for(int j = 0 ; j < bright.size() ; j++)
-        {
-            PATCH patch = bright[j];
-            for(int k = 0 ; k < patch.size() ; k++)
-            {
-                patch[k] += distribution(gen);
-            }
-        }
-        
-        DBG("===== Bright Error =====");
-        errorCheck(spectralTags[0], bright);
-        addAugmentedSpectralTags(bright, spectralParents[0], spectralChild[0]);
-        
-        TagVector dark = spectralTags[1];
-        for(int j = 0 ; j < dark.size() ; j++)
-        {
-            PATCH patch = dark[j];
-            for(int k = 0 ; k < patch.size() ; k++)
-            {
-                patch[k] += distribution(gen);
-            }
-        }
-        
-        DBG("===== Dark Error =====");
-        errorCheck(spectralTags[1], dark);
-        addAugmentedSpectralTags(dark, spectralParents[1], spectralChild[1]);
+        // a partial pass spreads its rows evenly over the tag
+        for(int i = 0 ; i < numRows ; i++)
+            column[(size_t)i] = patches.get(AugmentPlan::getSourceRow(i, numRows, numSource), k);
         
-        TagVector resonant = spectralTags[2];
-        for(int j = 0 ; j < resonant.size() ; j++)
-        {
-            PATCH patch = resonant[j];
-            for(int k = 0 ; k < patch.size() ; k++)
-            {
-                patch[k] += distribution(gen);
-            }
-        }
-        
-        DBG("===== Resonant Error =====");
-        errorCheck(spectralTags[2], resonant);
-        addAugmentedSpectralTags(resonant, spectralParents[2], spectralChild[2]);
-        
-        TagVector soft = spectralTags[3];
-        for(int j = 0 ; j < soft.size() ; j++)
-        {
-            PATCH patch = soft[j];
-            for(int k = 0 ; k < patch.size() ; k++)
-            {
-                patch[k] += distribution(gen);
-            }
-        }
+        noise.addNoise(column.data(), numRows, k, tag, replica);
         
-        DBG("===== Soft Error =====");
-        errorCheck(spectralTags[3], soft);
-        addAugmentedSpectralTags(soft, spectralParents[3], spectralChild[3]);
+        for(int i = 0 ; i < numRows ; i++)
+            noisy.set(i, k, column[(size_t)i]);
     }
+    
+    return noisy;
 }
 
-void TT_Augmenter::injectNoiseTemporalTags()
+PatchMatrix TT_Augmenter::synthesise(PatchView patches, const std::vector<int>& neighbours, const TT_NoiseEngine& random, int tag, int replica, int numRows) const
 {
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_real_distribution<double> distribution(-0.15, 0.15);
+    const int numSource = patches.getNumRows();
+    jassert(numRows <= numSource);
+    const int numParams = patches.getNumParams();
+    const int k = numNeighbours;
+    
+    // the engine's streams past the last parameter pick the neighbour and the point between
+    std::vector<float> picks ((size_t)numRows);
+    std::vector<float> gaps ((size_t)numRows);
+    random.fillUniform(picks.data(), numRows, numParams, tag, replica);
+    random.fillUniform(gaps.data(), numRows, numParams + 1, tag, replica);
     
-    for(int i = 0 ; i < scaleFactor ; i++)
+    PatchMatrix synthetic (numRows, numParams);
+    
+    for(int i = 0 ; i < numRows ; i++)
     {
-        TagVector pluck = temporalTags[0];
-        for(int j = 0 ; j < pluck.size() ; j++)
-        {
-            PATCH patch = pluck[j];
-            for(int k = 0 ; k < patch.size() ; k++)
-            {
-                patch[k] += distribution(gen);
-            }
-        }
+        const int source = AugmentPlan::getSourceRow(i, numRows, numSource);
+        const int* candidates = neighbours.data() + (size_t)source * (size_t)k;
+        const int numFound = (int)(std::find(candidates, candidates + k, -1) - candidates);
         
-        DBG("===== Pluck Error =====");
-        errorCheck(temporalTags[0], pluck);
-        addAugmentedTemporalTags(pluck, temporalParents[0], temporalChild[0]);
+        Span<const float> patch = patches.getRow(source);
+        Span<float> output = synthetic.getRow(i);
         
-        TagVector longRelease = temporalTags[1];
-        for(int j = 0 ; j < longRelease.size() ; j++)
+        // a tag with a single patch can only repeat it
+        if(numFound == 0)
         {
-            PATCH patch = longRelease[j];
-            for(int k = 0 ; k < patch.size() ; k++)
-            {
-                patch[k] += distribution(gen);
-            }
+            std::copy(patch.begin(), patch.end(), output.begin());
+            continue;
         }
         
-        DBG("===== Long Release Error =====");
-        errorCheck(temporalTags[1], longRelease);
-        addAugmentedTemporalTags(longRelease, temporalParents[1], temporalChild[1]);
-        
-        TagVector swell = temporalTags[2];
-        for(int j = 0 ; j < swell.size() ; j++)
-        {
-            PATCH patch = swell[j];
-            for(int k = 0 ; k < patch.size() ; k++)
-            {
-                patch[k] += distribution(gen);
-            }
-        }
+        const int pick = juce::jmin(numFound - 1, (int)((picks[(size_t)i] * 0.5f + 0.5f) * numFound));
+        Span<const float> neighbour = patches.getRow(candidates[pick]);
+        const float gap = gaps[(size_t)i] * 0.5f + 0.5f;
         
-        DBG("===== Swell Error =====");
-        errorCheck(temporalTags[2], swell);
-        addAugmentedTemporalTags(swell, temporalParents[2], temporalChild[2]);
-        
-        TagVector shortTag = temporalTags[3];
-        for(int j = 0 ; j < swell.size() ; j++)
-        {
-            PATCH patch = shortTag[j];
-            for(int k = 0 ; k < patch.size() ; k++)
-            {
-                patch[k] += distribution(gen);
-            }
-        }
-        
-        DBG("===== Short Error =====");
-        errorCheck(temporalTags[3], shortTag);
-        addAugmentedTemporalTags(shortTag, temporalParents[3], temporalChild[3]);
+        for(int p = 0 ; p < numParams ; p++)
+            output[(size_t)p] = patch[(size_t)p] + gap * (neighbour[(size_t)p] - patch[(size_t)p]);
     }
-}
-
-void TT_Augmenter::addAugmentedSpectralTags(TagVector toAdd, juce::Identifier parent, juce::Identifier child)
-{
-    juce::ValueTree parentTree = spectralTree.getChildWithName(parent);
     
-    for(int i = 0 ; i < toAdd.size() ; i++)
-    {
-        juce::ValueTree newChild {child};
-        for(int j = 0 ; j < toAdd[i].size() ; j++)
-        {
-            newChild.setProperty(spectralParams[j], toAdd[i][j], nullptr);
-        }
-        parentTree.appendChild(newChild, nullptr);
-    }
+    return synthetic;
 }
 
-void TT_Augmenter::addAugmentedTemporalTags(TagVector toAdd, juce::Identifier parent, juce::Identifier child)
+void TT_Augmenter::addAugmentedSpectralTags(PatchView toAdd, int tag)
 {
-    juce::ValueTree parentTree = temporalTree.getChildWithName(parent);
-    
-    for(int i = 0 ; i < toAdd.size() ; i++)
-    {
-        juce::ValueTree newChild {child};
-        for(int j = 1 ; j < toAdd[i].size() ; j++)
-        {
-            newChild.setProperty(temporalParams[j], toAdd[i][j], nullptr);
-        }
-        parentTree.appendChild(newChild, nullptr);
-    }
+    addAugmentedRows(spectralDataset, toAdd, tag);
 }
 
-void TT_Augmenter::sortTagVector(TagVector input)
+void TT_Augmenter::addAugmentedTemporalTags(PatchView toAdd, int tag)
 {
-    std::sort(input.begin(), input.end(), [this] (PATCH a, PATCH b) { return calculateMagnitude(a) > calculateMagnitude(b); });
+    addAugmentedRows(temporalDataset, toAdd, tag);
 }
 
-void TT_Augmenter::sortMagVector(std::vector<float> input)
+void TT_Augmenter::addAugmentedRows(TT_PatchStore& dataset, PatchView toAdd, int tag)
 {
-    std::sort(input.begin(), input.end(), [this] (float a, float b) { return a > b; });
+    // interpolated spectral patches don't carry every parameter, missing ones are left at 0
+    dataset.addRows(toAdd, TT_PatchStore::tagBit(tag));
 }
 
-void TT_Augmenter::errorCheck(TagVector original, TagVector expanded)
+juce::ValueTree TT_Augmenter::createDataTree() const
 {
-    std::vector<float> originalMags;
-    std::vector<float> expandedMags;
-    
-    for(int i = 0 ; i < original.size() ; i++)
-        originalMags.push_back(calculateMagnitude(original[i]));
-    
-    for(int i = 0 ; i < original.size() ; i++)
-        expandedMags.push_back(calculateMagnitude(expanded[i]));
-    
-    float originalMean = 0;
-    for(int i = 0 ; i < originalMags.size() ; i++)
-        originalMean += originalMags[i];
-    
-    originalMean /= originalMags.size();
-    
-    float expandedMean = 0;
-    for(int i = 0 ; i < expandedMags.size() ; i++)
-        expandedMean += expandedMags[i];
+    juce::Array<juce::Identifier> temporalFeatures;
+    for(int i = firstTemporalFeature ; i < temporalParams.size() ; i++) // env type isn't kept past cleaning
+        temporalFeatures.add(temporalParams[i]);
     
-    expandedMean /= expandedMags.size();
+    juce::ValueTree dataTree {DataNodes::Data};
+    dataTree.appendChild(spectralDataset.createValueTree(DataNodes::TypeNodes::Spectral, spectralParents, spectralChild, spectralParams), nullptr);
+    dataTree.appendChild(temporalDataset.createValueTree(DataNodes::TypeNodes::Temporal, temporalParents, temporalChild, temporalFeatures), nullptr);
     
-    DBG("original mean = " << originalMean);
-    DBG("expanded mean = " << expandedMean);
+    return dataTree;
 }
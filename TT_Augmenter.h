@@ -9,17 +9,21 @@
 */
 
 #pragma once
-#include <random>
-#include "TT_SpectralInterpolator.h"
-#include "TT_TemporalInterpolator.h"
+#include "TT_Interpolator.h"
 #include "TT_DataNodes.h"
 #include "TT_Fetcher.h"
-#include "TT_Thresholds.h"
+#include "TT_KdTree.h"
+#include "TT_Magnitude.h"
+#include "TT_NoiseEngine.h"
+#include "TT_CleaningRules.h"
+#include "TT_Statistics.h"
+#include "TT_AugmentPlan.h"
 
 enum Mode
 {
     INTERP = 0,
-    NOISE
+    NOISE,
+    SMOTE // between each patch and one of its k nearest neighbours in parameter space
 };
 
 class TT_Augmenter
@@ -30,69 +34,105 @@ public:
     ~TT_Augmenter();
     
     void setMode(Mode newMode) { mode = newMode; }
+    Mode getMode() const { return mode; }
+    int getScaleFactor() const { return scaleFactor; }
     
-    void fetchSpectralData();
-    void fetchBrightData();
-    void fetchDarkData();
-    void fetchResonantData();
-    void fetchSoftData();
+    // curve INTERP mode draws through each tag's patches, see TT_Spline.h
+    void setInterpolationKind(InterpolationKind newKind) { interpolationKind = newKind; }
+    InterpolationKind getInterpolationKind() const { return interpolationKind; }
+    
+    // per tag row counts, see TT_AugmentPlan.h, for augmentTags and the training batch sources.
+    // a target takes priority over a budget, with neither every tag grows by scaleFactor
+    void setTargetRowsPerTag(int numRows) { targetRowsPerTag = juce::jmax(0, numRows); }
+    void setRowBudget(int numRows) { rowBudget = juce::jmax(0, numRows); } // per type, originals included
+    std::vector<int> planAugmentation(const std::vector<PatchMatrix>& tags) const;
+    
+    // neighbours SMOTE picks from
+    void setNumNeighbours(int newNumNeighbours) { numNeighbours = juce::jmax(1, newNumNeighbours); }
+    int getNumNeighbours() const { return numNeighbours; }
     
+    // cleans every tag with its rules from TT_CleaningRules.h
+    void fetchSpectralData();
     void fetchTemporalData();
-    void fetchPluckData();
-    void fetchLongReleaseData();
-    void fetchSwellData();
-    void fetchShortData();
     
+    // augments every tag of both types as one batch of parallel tasks
+    void augmentTags();
     void augmentSpectralTags();
     void augmentTemporalTags();
     
-    void interpolateSpectralTags();
-    void interpolateTemporalTags();
+    // 1 runs every augmentation task on the calling thread
+    void setNumThreads(int newNumThreads) { numThreads = juce::jmax(1, newNumThreads); }
     
-    void injectNoiseSpectralTags();
-    void injectNoiseTemporalTags();
+    // noise mode settings, amount and per parameter scales are set on the engines directly
+    void setNoiseSeed(juce::uint64 seed) { spectralNoise.setSeed(seed); temporalNoise.setSeed(seed); }
+    TT_NoiseEngine& getSpectralNoise() { return spectralNoise; }
+    TT_NoiseEngine& getTemporalNoise() { return temporalNoise; }
     
-    void addAugmentedSpectralTags(TagVector toAdd, juce::Identifier parent, juce::Identifier child);
-    void addAugmentedTemporalTags(TagVector toAdd, juce::Identifier parent, juce::Identifier child);
-
-    void sortTagVector(TagVector input);
-    void sortMagVector(std::vector<float> input);
+    // cleaned originals, one matrix per tag sorted by descending magnitude
+    const std::vector<PatchMatrix>& getSpectralTags() const { return spectralTags; }
+    const std::vector<PatchMatrix>& getTemporalTags() const { return temporalTags; }
+    
+    void addAugmentedSpectralTags(PatchView toAdd, int tag);
+    void addAugmentedTemporalTags(PatchView toAdd, int tag);
     
-    std::shared_ptr<juce::ValueTree> const& getDataTree() { return dataTree; }
+    // cleaned originals plus augmented rows, one row per training sample tagged with its label
+    const TT_PatchStore& getSpectralDataset() const { return spectralDataset; }
+    const TT_PatchStore& getTemporalDataset() const { return temporalDataset; }
     
-    void errorCheck(TagVector original, TagVector expanded);
+    // ValueTree copy of the datasets for the GUI and debugging
+    juce::ValueTree createDataTree() const;
+    
+    // original vs augmented statistics of every tag touched by the last augmentTags / augment*Tags call
+    const TT_Statistics& getStatistics() const { return statistics; }
+    bool writeStatisticsReport(const juce::File& file) const { return statistics.writeReport(file, numThreads); }
+    
+    // PatchMatrix buffer allocations made by the last augmentTags / augment*Tags call, roughly one
+    // per task output, sorting is in place and other scratch buffers aren't counted
+    int getNumAllocations() const { return numAllocations; }
     
 private:
     
-    float calculateMagnitude(PATCH input)
+    void cleanTag(const TT_PatchStore& store, int tag, const Cleaning::TagRules& rules, int firstFeature,
+                  TT_PatchStore& dataset, std::vector<PatchMatrix>& tags);
+    // one tag x replica, results are only written to the datasets once every task is done
+    struct AugmentTask
     {
-        float magnitudeSqr = 0.f;
-        for(int i = 0 ; i < input.size() - 2 ; i++)
-        {
-            float param = input[i];
-            magnitudeSqr += param * param;
-        }
-        float magnitude = std::sqrt(magnitudeSqr);
-        
-        return magnitude;
-    }
-
+        bool isTemporal = false;
+        int tag = 0;
+        int replica = 0;
+        int numRows = 0;
+        const std::vector<int>* neighbours = nullptr; // SMOTE only
+        PatchMatrix result;
+    };
+    
+    void runAugmentTasks(bool spectral, bool temporal);
+    PatchMatrix augmentTag(const AugmentTask& task) const;
+    PatchMatrix addNoise(PatchView patches, const TT_NoiseEngine& noise, int tag, int replica, int numRows) const;
+    PatchMatrix synthesise(PatchView patches, const std::vector<int>& neighbours, const TT_NoiseEngine& random, int tag, int replica, int numRows) const;
+    static PatchMatrix selectRows(PatchMatrix rows, int numRows);
+    void addAugmentedRows(TT_PatchStore& dataset, PatchView toAdd, int tag);
+    
     Mode mode;
+    InterpolationKind interpolationKind = LINEAR;
+    
+    TT_PatchStore spectralDataset {DataNodes::ParameterNodes::numSpectralParams};
+    TT_PatchStore temporalDataset {DataNodes::ParameterNodes::numTemporalFeatures};
     
-    std::shared_ptr<juce::ValueTree> dataTree;
-    juce::ValueTree spectralTree;
-    juce::ValueTree temporalTree;
+    TT_NoiseEngine spectralNoise {DataNodes::ParameterNodes::numSpectralParams, 0};
+    TT_NoiseEngine temporalNoise {DataNodes::ParameterNodes::numTemporalFeatures, 1};
     
-    TT_SpectralInterpolator spectralInterpolator;
-    TT_TemporalInterpolator temporalInterpolator;
     TT_Fetcher* fetcher;
     
     // Data vectors - Index of parameters in patch vectors correspond to index of parameter in ParameterNodes arrays
-    std::vector<TagVector> spectralTags;
-    std::vector<TagVector> temporalTags;
+    std::vector<PatchMatrix> spectralTags;
+    std::vector<PatchMatrix> temporalTags;
     
-    std::vector<std::vector<float>> spectralMags;
-    std::vector<std::vector<float>> temporalMags;
+    TT_Statistics statistics;
     
     int scaleFactor = 3;
+    int targetRowsPerTag = 0;
+    int rowBudget = 0;
+    int numNeighbours = 5;
+    int numThreads = Parallel::defaultNumThreads();
+    int numAllocations = 0;
 };
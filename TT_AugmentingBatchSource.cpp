@@ -0,0 +1,252 @@
+/*
+  ==============================================================================
+
+    TT_AugmentingBatchSource.cpp
+    Created: 20 Oct 2026 11:47:30am
+    Author:  Matt Twitchen
+
+  ==============================================================================
+*/
+
+#include "TT_AugmentingBatchSource.h"
+
+TT_AugmentingBatchSource::TT_AugmentingBatchSource(const std::vector<PatchMatrix>& tags, const tensor_t& tagLabels, Mode augmentMode, const std::vector<int>& plan,
+                                                   const TT_NoiseEngine& noiseEngine, int k, float validateProp)
+    : mode(augmentMode), noise(noiseEngine)
+{
+    numNeighbours = mode == SMOTE ? juce::jmax(1, k) : 1;
+    jassert(tags.size() <= tagLabels.size());
+    jassert(tags.size() == plan.size());
+    noise.setStream(streamID);
+    
+    const int numParams = tags.empty() ? 0 : tags.front().getNumParams();
+    trainRows = PatchMatrix (numParams);
+    labels = tagLabels;
+    
+    for(int tag = 0 ; tag < (int)tags.size() ; tag++)
+    {
+        const PatchMatrix& patches = tags[(size_t)tag];
+        const int firstRow = trainRows.getNumRows();
+        
+        for(int i = 0 ; i < patches.getNumRows() ; i++)
+        {
+            Span<const float> patch = patches.getRow(i);
+            
+            // spreads exactly validateProp of every tag over its magnitude range
+            if((int)((i + 1) * validateProp) > (int)(i * validateProp))
+            {
+                validateData.push_back(vec_t (patch.begin(), patch.end()));
+                validateLabels.push_back(tagLabels[(size_t)tag]);
+                continue;
+            }
+            
+            trainRows.addRow(patch.data());
+            rowTags.push_back(tag);
+        }
+        
+        findNeighbours(firstRow, trainRows.getNumRows());
+        
+        // the plan counts held out originals as well, the training share of it keeps the tag at its planned proportion
+        const int numTrain = trainRows.getNumRows() - firstRow;
+        const int numPlanned = tag < (int)plan.size() ? plan[(size_t)tag] : 0;
+        const int numAugmented = patches.getNumRows() > 0 ? (int)((juce::int64)numPlanned * numTrain / patches.getNumRows()) : 0;
+        
+        addSlots(firstRow, trainRows.getNumRows(), numAugmented);
+    }
+}
+
+void TT_AugmentingBatchSource::addSlots(int firstRow, int lastRow, int numAugmented)
+{
+    const int numTrain = lastRow - firstRow;
+    
+    for(int row = firstRow ; row < lastRow ; row++)
+        slots.push_back({row, false});
+    
+    if(numTrain == 0)
+        return;
+    
+    for(int i = 0 ; i < numAugmented ; i++)
+        slots.push_back({firstRow + AugmentPlan::getSourceRow(i, numAugmented, numTrain), true});
+}
+
+void TT_AugmentingBatchSource::findNeighbours(int firstRow, int lastRow)
+{
+    if(mode != SMOTE)
+    {
+        for(int row = firstRow ; row < lastRow ; row++)
+            neighbours.push_back(row < lastRow - 1 ? row + 1 : juce::jmax(firstRow, row - 1));
+        return;
+    }
+    
+    const PatchView tagRows (trainRows.getRow(firstRow).data(), lastRow - firstRow, trainRows.getNumParams());
+    TT_KdTree tree (tagRows);
+    
+    for(int found : tree.findNeighboursOfPoints(numNeighbours, Parallel::defaultNumThreads()))
+        neighbours.push_back(found < 0 ? -1 : firstRow + found);
+}
+
+void TT_AugmentingBatchSource::setStatistics(TT_Statistics* newStatistics, const juce::String& typeName, const juce::Array<juce::Identifier>& tagNames)
+{
+    statistics = newStatistics;
+    statisticsNames.clear();
+    
+    if(statistics == nullptr)
+        return;
+    
+    for(auto& tagName : tagNames)
+        statisticsNames.add(typeName + " " + tagName.toString());
+    
+    // training rows are grouped by tag
+    int firstRow = 0;
+    while(firstRow < getNumTrainSamples())
+    {
+        const int tag = rowTags[(size_t)firstRow];
+        int lastRow = firstRow;
+        while(lastRow < getNumTrainSamples() && rowTags[(size_t)lastRow] == tag)
+            lastRow++;
+        
+        if(tag < statisticsNames.size())
+            statistics->addOriginal(statisticsNames[tag], PatchView (trainRows.getRow(firstRow).data(), lastRow - firstRow, trainRows.getNumParams()));
+        
+        firstRow = lastRow;
+    }
+}
+
+void TT_AugmentingBatchSource::prepare(size_t newBatchSize)
+{
+    batchSize = juce::jmax((size_t)1, newBatchSize);
+    
+    const int numSamples = getNumSamplesPerEpoch();
+    numBatches = (int)((numSamples + batchSize - 1) / batchSize);
+    
+    column.resize(batchSize);
+    uniforms.resize(batchSize);
+    generated = PatchMatrix ((int)batchSize, trainRows.getNumParams());
+    tagRows = PatchMatrix (trainRows.getNumParams());
+    tagRows.reserve((int)batchSize);
+}
+
+int TT_AugmentingBatchSource::fillBatch(tensor_t& inputs, tensor_t& targets, int epoch, int batch)
+{
+    updateOrder(epoch);
+    
+    const int first = batch * (int)batchSize;
+    const int numSlots = juce::jmax(0, juce::jmin((int)batchSize, getNumSamplesPerEpoch() - first));
+    const int numParams = trainRows.getNumParams();
+    
+    // rows keep their vec_t from one batch to the next, only a short last batch changes the count
+    inputs.resize((size_t)numSlots, vec_t (labels.empty() ? 0 : labels.front().size()));
+    targets.resize((size_t)numSlots, vec_t ((size_t)numParams));
+    
+    if(numSlots == 0)
+        return 0;
+    
+    const juce::uint32 sequence = (juce::uint32)epoch * (juce::uint32)numBatches + (juce::uint32)batch;
+    
+    // training row and augmentation of every slot in the batch
+    std::vector<int> rows ((size_t)numSlots);
+    std::vector<bool> augmented ((size_t)numSlots);
+    for(int i = 0 ; i < numSlots ; i++)
+    {
+        const Slot& slot = slots[(size_t)order[(size_t)(first + i)]];
+        rows[(size_t)i] = slot.row;
+        augmented[(size_t)i] = slot.augmented;
+    }
+    
+    // stream numParams + 1 holds the interpolation points and numParams + 2 picks the neighbour
+    
+    const bool interpolates = mode == INTERP || mode == SMOTE;
+    std::vector<int> partners ((size_t)numSlots);
+    
+    if(interpolates)
+    {
+        noise.fillUniform(uniforms.data(), numSlots, numParams + 2, sequence);
+        for(int i = 0 ; i < numSlots ; i++)
+        {
+            const int row = rows[(size_t)i];
+            const int* candidates = neighbours.data() + (size_t)row * (size_t)numNeighbours;
+            const int numFound = juce::jmax(1, (int)(std::find(candidates, candidates + numNeighbours, -1) - candidates));
+            const int pick = juce::jmin(numFound - 1, (int)((uniforms[(size_t)i] * 0.5f + 0.5f) * numFound));
+            
+            // a tag with a single training patch interpolates with itself
+            partners[(size_t)i] = candidates[pick] < 0 ? row : candidates[pick];
+        }
+        
+        noise.fillUniform(uniforms.data(), numSlots, numParams + 1, sequence);
+        for(int i = 0 ; i < numSlots ; i++)
+            uniforms[(size_t)i] = augmented[(size_t)i] ? uniforms[(size_t)i] * 0.5f + 0.5f : 0.0f;
+    }
+    
+    for(int k = 0 ; k < numParams ; k++)
+    {
+        for(int i = 0 ; i < numSlots ; i++)
+        {
+            const int row = rows[(size_t)i];
+            const float value = trainRows.get(row, k);
+            
+            if(interpolates)
+                column[(size_t)i] = value + (trainRows.get(partners[(size_t)i], k) - value) * uniforms[(size_t)i];
+            else
+                column[(size_t)i] = value;
+        }
+        
+        if(mode == NOISE)
+        {
+            noise.addNoise(column.data(), numSlots, k, sequence);
+            
+            // originals keep their exact values
+            for(int i = 0 ; i < numSlots ; i++)
+            {
+                if(!augmented[(size_t)i])
+                    column[(size_t)i] = trainRows.get(rows[(size_t)i], k);
+            }
+        }
+        
+        for(int i = 0 ; i < numSlots ; i++)
+            targets[(size_t)i][(size_t)k] = column[(size_t)i];
+        
+        if(statistics != nullptr)
+        {
+            for(int i = 0 ; i < numSlots ; i++)
+                generated.set(i, k, column[(size_t)i]);
+        }
+    }
+    
+    if(statistics != nullptr)
+        addToStatistics(rows, augmented);
+    
+    for(int i = 0 ; i < numSlots ; i++)
+        inputs[(size_t)i] = labels[(size_t)rowTags[(size_t)rows[(size_t)i]]];
+    
+    return numSlots;
+}
+
+void TT_AugmentingBatchSource::addToStatistics(const std::vector<int>& rows, const std::vector<bool>& augmented)
+{
+    for(int tag = 0 ; tag < statisticsNames.size() ; tag++)
+    {
+        tagRows.resize(0);
+        for(int i = 0 ; i < (int)rows.size() ; i++)
+        {
+            if(augmented[(size_t)i] && rowTags[(size_t)rows[(size_t)i]] == tag)
+                tagRows.addRow(generated.getRow(i).data());
+        }
+        
+        if(!tagRows.empty())
+            statistics->addAugmented(statisticsNames[tag], tagRows);
+    }
+}
+
+void TT_AugmentingBatchSource::updateOrder(int epoch)
+{
+    if(epoch == orderEpoch)
+        return;
+    
+    order.resize(slots.size());
+    std::iota(order.begin(), order.end(), 0);
+    
+    std::mt19937 generator ((std::mt19937::result_type)(noise.getSeed() ^ (juce::uint64)epoch));
+    std::shuffle(order.begin(), order.end(), generator);
+    
+    orderEpoch = epoch;
+}
@@ -0,0 +1,152 @@
+/*
+  ==============================================================================
+
+    TT_AugmentingBatchSource.h
+    Created: 20 Oct 2026 11:47:30am
+    Author:  Matt Twitchen
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "../tiny-dnn-master/tiny_dnn/tiny_dnn.h"
+#include "TT_Augmenter.h"
+#include <random>
+
+using namespace tiny_dnn;
+
+/*
+ Generates augmented training samples batch by batch while a model trains.
+ 
+ Only the cleaned originals are held. How many augmented samples each tag gets comes
+ from the augmenter's plan, see TT_AugmentPlan.h, so majority tags can be left alone
+ while minority tags are topped up. The plan counts every original, a fraction of them
+ is held out, unaugmented, for validation, and each tag's planned count is scaled down
+ by the same fraction so the tags keep the balance the plan gave them.
+ 
+ An epoch is a fixed list of slots, every training original once plus the tag's
+ planned count of augmented slots spread evenly over its originals, gone through in a
+ fresh order. Every augmented slot is a new sample made from its original:
+ 
+    NOISE  - the original plus noise from the noise engine
+    INTERP - a random point between the original and its magnitude neighbour in the same tag
+    SMOTE  - a random point between the original and one of its k nearest neighbours in the same tag
+ 
+ The number of samples, and so of gradient steps, per epoch is known up front. train()
+ generates one batch, fits the network on it and moves on, so besides the originals only
+ a single batch of samples is ever held and every epoch sees new ones. Randomness is
+ counter based on (epoch, batch), the same seed gives the same run.
+ 
+ With statistics set, the training originals of every tag are added once and every
+ augmented sample is added as its batch is generated, so the report covers exactly
+ what the model was trained on.
+ */
+
+class TT_AugmentingBatchSource
+{
+public:
+    
+    // tags are the augmenter's cleaned originals, one matrix per tag, tagLabels are indexed the same,
+    // plan is the number of augmented rows per tag from TT_Augmenter::planAugmentation
+    TT_AugmentingBatchSource(const std::vector<PatchMatrix>& tags, const tensor_t& tagLabels, Mode mode, const std::vector<int>& plan,
+                             const TT_NoiseEngine& noise, int numNeighbours = 5, float validateProp = 0.2f);
+    
+    int getNumTrainSamples() const { return trainRows.getNumRows(); }
+    // training originals plus augmented samples, the same every epoch
+    int getNumSamplesPerEpoch() const { return (int)slots.size(); }
+    int getNumValidateSamples() const { return (int)validateData.size(); }
+    
+    // sizes the per batch scratch buffers
+    void prepare(size_t batchSize);
+    int getNumBatches() const { return numBatches; }
+    
+    // adds the training originals now and every augmented sample from then on, names are
+    // "<typeName> <tag>" like the augmenter's, statistics must outlive the source or be reset to nullptr
+    void setStatistics(TT_Statistics* newStatistics, const juce::String& typeName, const juce::Array<juce::Identifier>& tagNames);
+    
+    // generates one batch of the given epoch into inputs (labels) and targets (parameters), sized to
+    // the batch, returns the number of samples
+    int fillBatch(tensor_t& inputs, tensor_t& targets, int epoch, int batch);
+    
+    const tensor_t& getValidateLabels() const { return validateLabels; }
+    const tensor_t& getValidateData() const { return validateData; }
+    
+    // trains nn on generated batches and logs the validation loss every epoch. each batch is its own
+    // fit call on freshly filled tensors, so nothing relies on fit reading the caller's buffers in place
+    template <typename Network, typename Optimizer>
+    void train(Network& nn, const Optimizer& optimizerSettings, size_t trainBatchSize, int epochs)
+    {
+        // fit resets its optimizer on every call, the moments have to carry over from one batch to the next
+        struct PersistentOptimizer : Optimizer
+        {
+            PersistentOptimizer(const Optimizer& settings) : Optimizer(settings) {}
+            void reset() override {}
+        };
+        
+        PersistentOptimizer optimizer (optimizerSettings);
+        tensor_t inputs;
+        tensor_t targets;
+        
+        prepare(trainBatchSize);
+        
+        for(int epoch = 0 ; epoch < epochs ; epoch++)
+        {
+            for(int batch = 0 ; batch < numBatches ; batch++)
+            {
+                const int numSlots = fillBatch(inputs, targets, epoch, batch);
+                nn.template fit<mse>(optimizer, inputs, targets, (size_t)numSlots, 1, [](){}, [](){});
+            }
+            
+            float loss = nn.template get_loss<mse>(validateLabels, validateData);
+            DBG("loss = " << loss);
+        }
+    }
+    
+private:
+    
+    void updateOrder(int epoch);
+    
+    void addSlots(int firstRow, int lastRow, int numAugmented);
+    void findNeighbours(int firstRow, int lastRow);
+    void addToStatistics(const std::vector<int>& rows, const std::vector<bool>& augmented);
+    
+    // training originals sorted by tag then magnitude
+    PatchMatrix trainRows;
+    std::vector<int> rowTags;
+    
+    // numNeighbours per row, -1 past the last one found, INTERP only uses the next row of the same tag
+    std::vector<int> neighbours;
+    int numNeighbours = 1;
+    
+    tensor_t labels;
+    tensor_t validateLabels;
+    tensor_t validateData;
+    
+    // one per sample of an epoch, in tag order, updateOrder shuffles them
+    struct Slot
+    {
+        int row;
+        bool augmented;
+    };
+    
+    std::vector<Slot> slots;
+    
+    Mode mode;
+    TT_NoiseEngine noise;
+    
+    size_t batchSize = 1;
+    int numBatches = 0;
+    
+    std::vector<int> order; // slot of every position in the current epoch
+    int orderEpoch = -1;
+    
+    std::vector<float> column; // scratch, one batch of one parameter
+    std::vector<float> uniforms;
+    
+    TT_Statistics* statistics = nullptr;
+    juce::StringArray statisticsNames; // indexed by tag
+    PatchMatrix generated; // scratch, the current batch row by row, only filled for statistics
+    PatchMatrix tagRows; // scratch, the augmented rows of one tag in the current batch
+    
+    static constexpr juce::uint32 streamID = 2; // the augmenter's engines use 0 and 1
+};
@@ -0,0 +1,77 @@
+/*
+  ==============================================================================
+
+    TT_CleaningRules.h
+    Created: 18 Oct 2026 5:14:03pm
+    Author:  Matt Twitchen
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "TT_Thresholds.h"
+#include "TT_DataNodes.h"
+
+/*
+ Per tag cleaning rules, indexed like the Spectral / Temporal patchTags arrays.
+ 
+ A rule replaces the values of one parameter column that sit on the wrong side of its
+ threshold with the mean of that column over every patch carrying the tag. Params are
+ ParameterNodes columns of the full Spectral / Temporal rows, so temporal rules can look
+ at env type.
+ */
+
+namespace Cleaning
+{
+    enum Direction
+    {
+        Below = 0, // replace values <= threshold
+        Above      // replace values >= threshold
+    };
+    
+    struct Rule
+    {
+        int param;
+        Direction direction;
+        float threshold;
+    };
+    
+    static constexpr int maxRules = 2;
+    
+    struct TagRules
+    {
+        int numRules;
+        Rule rules[maxRules];
+        bool clearGateReleases; // zero the release params of patches with a gate envelope
+    };
+    
+    namespace Spectral
+    {
+        using Param = DataNodes::ParameterNodes::Spectral;
+        using DataNodes::ParameterNodes::column;
+        
+        static const TagRules rules[] = {{1, {{column(Param::FilterFrequency), Below, Thresholds::Spectral::Bright::filterFrequency}}, false},
+                                         {1, {{column(Param::FilterFrequency), Below, Thresholds::Spectral::Dark::filterFrequency}}, false},
+                                         {1, {{column(Param::FilterEmphasis), Below, Thresholds::Spectral::Resonant::filterEmphasis}}, false},
+                                         {2, {{column(Param::FilterFrequency), Below, Thresholds::Spectral::Soft::filterFrequency},
+                                              {column(Param::FilterEmphasis), Below, Thresholds::Spectral::Soft::filterEmphasis}}, false}};
+    }
+    
+    namespace Temporal
+    {
+        using Param = DataNodes::ParameterNodes::Temporal;
+        using DataNodes::ParameterNodes::column;
+        
+        static constexpr int envType = column(Param::EnvType); // 0 = gate
+        static constexpr int releaseParams[] = {column(Param::FilterRelease), column(Param::VcaRelease)};
+        
+        static const TagRules rules[] = {{2, {{column(Param::FilterAttack), Above, Thresholds::Temporal::Pluck::filterAttack},
+                                              {column(Param::VcaAttack), Above, Thresholds::Temporal::Pluck::vcaAttack}}, true},
+                                         {2, {{column(Param::FilterRelease), Below, Thresholds::Temporal::LongRelease::filterRelease},
+                                              {column(Param::VcaRelease), Below, Thresholds::Temporal::LongRelease::vcaRelease}}, false},
+                                         {2, {{column(Param::FilterAttack), Below, Thresholds::Temporal::Swell::filterAttack},
+                                              {column(Param::VcaAttack), Below, Thresholds::Temporal::Swell::vcaAttack}}, true},
+                                         {2, {{column(Param::VcaAttack), Above, Thresholds::Temporal::Short::vcaAttack},
+                                              {column(Param::VcaSustain), Above, Thresholds::Temporal::Short::vcaSustain}}, true}};
+    }
+}
@@ -10,13 +10,15 @@
 
 #pragma once
 #include <JuceHeader.h>
+#include <array>
+#include <iterator>
 
 namespace DataNodes
 {
     
     static const inline juce::Identifier Data {"Data"};
     static const inline juce::Identifier ParamValue {"Param_Value"};
-
+    
     namespace TypeNodes
     {
         static const inline juce::Identifier Spectral {"Spectral"};
@@ -25,6 +27,13 @@ namespace DataNodes
     
     namespace TagNodes
     {
+        // tag names in patchTags order, every tag index in the pipeline and TagTable follows these
+        static constexpr const char* spectralTagNames[] = {"Bright", "Dark", "Resonant", "Soft"};
+        static constexpr const char* temporalTagNames[] = {"Pluck", "Long_Release", "Swell", "Short"};
+        
+        static constexpr int numSpectralTags = (int)std::size(spectralTagNames);
+        static constexpr int numTemporalTags = (int)std::size(temporalTagNames);
+        
         namespace Spectral
         {
             namespace Parents
@@ -40,10 +49,10 @@ namespace DataNodes
         
             namespace Patch
             {
-                static const inline juce::Identifier Bright {"Bright"};
-                static const inline juce::Identifier Dark {"Dark"};
-                static const inline juce::Identifier Resonant {"Resonant"};
-                static const inline juce::Identifier Soft {"Soft"};
+                static const inline juce::Identifier Bright {spectralTagNames[0]};
+                static const inline juce::Identifier Dark {spectralTagNames[1]};
+                static const inline juce::Identifier Resonant {spectralTagNames[2]};
+                static const inline juce::Identifier Soft {spectralTagNames[3]};
             
                 const juce::Array<juce::Identifier> patchTags {Bright, Dark, Resonant, Soft};
             };
@@ -64,10 +73,10 @@ namespace DataNodes
         
             namespace Patch
             {
-                static const inline juce::Identifier Pluck {"Pluck"};
-                static const inline juce::Identifier LongRelease {"Long_Release"};
-                static const inline juce::Identifier Swell {"Swell"};
-                static const inline juce::Identifier Short {"Short"};
+                static const inline juce::Identifier Pluck {temporalTagNames[0]};
+                static const inline juce::Identifier LongRelease {temporalTagNames[1]};
+                static const inline juce::Identifier Swell {temporalTagNames[2]};
+                static const inline juce::Identifier Short {temporalTagNames[3]};
             
                 const juce::Array<juce::Identifier> patchTags {Pluck, LongRelease, Swell, Short};
             
@@ -83,11 +92,113 @@ namespace DataNodes
             };
         };
     };
-
+    
     namespace ParameterNodes
     {
-        static const inline juce::Array<juce::Identifier> spectralParams = {"FilterFrequency", "FilterEmphasis", "FilterContour", "Osc2Detune", "Osc3Detune"};
-                                                                     
-        static const inline juce::Array<juce::Identifier> temporalParams = {"EnvType", "FilterAttack", "FilterDecay", "FilterSustain", "FilterRelease", "VcaAttack", "VcaDecay", "VcaSustain", "VcaRelease", "FilterContour"};
+        // column of every parameter in its type's stores and ParsedPatch value arrays
+        enum class Spectral
+        {
+            FilterFrequency = 0,
+            FilterEmphasis,
+            FilterContour,
+            Osc2Detune,
+            Osc3Detune,
+            numParams
+        };
+        
+        enum class Temporal
+        {
+            EnvType = 0, // 0 = gate, only used for cleaning
+            FilterAttack,
+            FilterDecay,
+            FilterSustain,
+            FilterRelease,
+            VcaAttack,
+            VcaDecay,
+            VcaSustain,
+            VcaRelease,
+            FilterContour,
+            numParams
+        };
+        
+        struct Parameter
+        {
+            const char* name; // id in the patch files and the ValueTree property name
+            int column;
+            float minimum;
+            float maximum;
+            float defaultValue;
+        };
+        
+        static constexpr Parameter spectralSchema[] = {{"FilterFrequency", (int)Spectral::FilterFrequency, 0.f, 1.f, 0.f},
+                                                       {"FilterEmphasis",  (int)Spectral::FilterEmphasis,  0.f, 1.f, 0.f},
+                                                       {"FilterContour",   (int)Spectral::FilterContour,   0.f, 1.f, 0.f},
+                                                       {"Osc2Detune",      (int)Spectral::Osc2Detune,      0.f, 1.f, 0.f},
+                                                       {"Osc3Detune",      (int)Spectral::Osc3Detune,      0.f, 1.f, 0.f}};
+        
+        static constexpr Parameter temporalSchema[] = {{"EnvType",       (int)Temporal::EnvType,       0.f, 1.f, 0.f},
+                                                       {"FilterAttack",  (int)Temporal::FilterAttack,  0.f, 1.f, 0.f},
+                                                       {"FilterDecay",   (int)Temporal::FilterDecay,   0.f, 1.f, 0.f},
+                                                       {"FilterSustain", (int)Temporal::FilterSustain, 0.f, 1.f, 0.f},
+                                                       {"FilterRelease", (int)Temporal::FilterRelease, 0.f, 1.f, 0.f},
+                                                       {"VcaAttack",     (int)Temporal::VcaAttack,     0.f, 1.f, 0.f},
+                                                       {"VcaDecay",      (int)Temporal::VcaDecay,      0.f, 1.f, 0.f},
+                                                       {"VcaSustain",    (int)Temporal::VcaSustain,    0.f, 1.f, 0.f},
+                                                       {"VcaRelease",    (int)Temporal::VcaRelease,    0.f, 1.f, 0.f},
+                                                       {"FilterContour", (int)Temporal::FilterContour, 0.f, 1.f, 0.f}};
+        
+        static constexpr int numSpectralParams = (int)Spectral::numParams;
+        static constexpr int numTemporalParams = (int)Temporal::numParams;
+        static constexpr int firstTemporalFeature = (int)Temporal::FilterAttack;
+        static constexpr int numTemporalFeatures = numTemporalParams - firstTemporalFeature; // env type is only used for cleaning
+        
+        constexpr int column(Spectral param) { return (int)param; }
+        constexpr int column(Temporal param) { return (int)param; }
+        
+        // column in the augmenter's temporal tags and datasets, which start at the first feature
+        constexpr int featureColumn(Temporal param) { return (int)param - firstTemporalFeature; }
+        
+        // the augmenter interpolates the leading spectral columns, FilterFrequency to Osc2Detune,
+        // Osc3Detune has never been interpolated and is left at 0 in augmented rows
+        static constexpr int numInterpolatedSpectralParams = column(Spectral::Osc2Detune) + 1;
+        static_assert(numInterpolatedSpectralParams == column(Spectral::Osc3Detune) && numInterpolatedSpectralParams < numSpectralParams,
+                      "interpolated spectral columns must be the ones before Osc3Detune");
+        
+        template <int numEntries>
+        constexpr bool isValidSchema(const Parameter (&schema)[numEntries])
+        {
+            for(int i = 0 ; i < numEntries ; i++)
+            {
+                if(schema[i].column != i || schema[i].minimum > schema[i].defaultValue || schema[i].defaultValue > schema[i].maximum)
+                    return false;
+            }
+            return true;
+        }
+        
+        static_assert(std::size(spectralSchema) == numSpectralParams && isValidSchema(spectralSchema), "spectralSchema must list every Spectral column in order");
+        static_assert(std::size(temporalSchema) == numTemporalParams && isValidSchema(temporalSchema), "temporalSchema must list every Temporal column in order");
+        
+        // starting values of a parsed patch, a parameter missing from the file keeps its default
+        template <int numEntries>
+        constexpr std::array<float, numEntries> getDefaultValues(const Parameter (&schema)[numEntries])
+        {
+            std::array<float, numEntries> values {};
+            for(int i = 0 ; i < numEntries ; i++)
+                values[(size_t)i] = schema[i].defaultValue;
+            return values;
+        }
+        
+        // names for the XML and ValueTree boundaries, nothing inside the pipeline looks parameters up by name
+        template <int numEntries>
+        static inline juce::Array<juce::Identifier> createIdentifiers(const Parameter (&schema)[numEntries])
+        {
+            juce::Array<juce::Identifier> ids;
+            for(auto& param : schema)
+                ids.add(param.name);
+            return ids;
+        }
+        
+        static const inline juce::Array<juce::Identifier> spectralParams = createIdentifiers(spectralSchema);
+        static const inline juce::Array<juce::Identifier> temporalParams = createIdentifiers(temporalSchema);
     };
 }
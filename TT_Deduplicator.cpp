@@ -0,0 +1,131 @@
+/*
+  ==============================================================================
+
+    TT_Deduplicator.cpp
+    Created: 18 Oct 2026 3:02:27pm
+    Author:  Matt Twitchen
+
+  ==============================================================================
+*/
+
+#include "TT_Deduplicator.h"
+#include <cmath>
+
+TT_Deduplicator::Result TT_Deduplicator::process(TT_PatchStore& store, int numTags) const
+{
+    Result result;
+    result.numExact.assign((size_t)numTags, 0);
+    result.numNear.assign((size_t)numTags, 0);
+    
+    const int numParams = store.getNumParams();
+    const bool findNear = tolerance > 0;
+    const float cellSize = tolerance * cellScale;
+    
+    // every table gets its own grid offset, the same for every tag
+    std::vector<float> offsets;
+    if(findNear)
+    {
+        juce::Random random (offsetSeed);
+        offsets.resize((size_t)(numTables * numParams));
+        for(auto& offset : offsets)
+            offset = random.nextFloat() * cellSize;
+    }
+    
+    const std::vector<float> zeroOffsets ((size_t)numParams, 0.0f);
+    
+    for(int tag = 0 ; tag < numTags ; tag++)
+    {
+        std::vector<int> rows = store.getRowsWithTag(tag);
+        
+        Buckets exact;
+        std::vector<Buckets> near ((size_t)(findNear ? numTables : 0));
+        exact.reserve(rows.size());
+        
+        for(int row : rows)
+        {
+            bool isDuplicate = false;
+            
+            // with a cell size of quantisationStep the cells are the quantised values
+            const juce::uint64 key = hashCells(store, row, quantisationStep, zeroOffsets.data());
+            std::vector<int>& bucket = exact[key];
+            for(int other : bucket)
+            {
+                if(isExactDuplicate(store, row, other))
+                {
+                    isDuplicate = true;
+                    result.numExact[(size_t)tag]++;
+                    break;
+                }
+            }
+            
+            std::vector<juce::uint64> nearKeys ((size_t)near.size());
+            for(size_t t = 0 ; t < near.size() && !isDuplicate ; t++)
+            {
+                nearKeys[t] = hashCells(store, row, cellSize, offsets.data() + t * (size_t)numParams);
+                
+                auto found = near[t].find(nearKeys[t]);
+                if(found == near[t].end())
+                    continue;
+                
+                for(int other : found->second)
+                {
+                    if(isNearDuplicate(store, row, other))
+                    {
+                        isDuplicate = true;
+                        result.numNear[(size_t)tag]++;
+                        break;
+                    }
+                }
+            }
+            
+            if(isDuplicate)
+            {
+                store.setTagMask(row, store.getTagMask(row) & ~TT_PatchStore::tagBit(tag));
+                continue;
+            }
+            
+            // only rows that are kept are compared against
+            bucket.push_back(row);
+            for(size_t t = 0 ; t < near.size() ; t++)
+                near[t][nearKeys[t]].push_back(row);
+        }
+    }
+    
+    return result;
+}
+
+juce::uint64 TT_Deduplicator::hashCells(const TT_PatchStore& store, int row, float cellSize, const float* offsets) const
+{
+    // FNV-1a over the cell index of every parameter
+    juce::uint64 hash = 14695981039346656037ull;
+    for(int i = 0 ; i < store.getNumParams() ; i++)
+    {
+        const juce::int64 cell = (juce::int64)std::floor((store.getValue(row, i) + offsets[i]) / cellSize);
+        for(int byte = 0 ; byte < 8 ; byte++)
+        {
+            hash ^= (juce::uint64)((cell >> (byte * 8)) & 0xff);
+            hash *= 1099511628211ull;
+        }
+    }
+    return hash;
+}
+
+bool TT_Deduplicator::isExactDuplicate(const TT_PatchStore& store, int row, int other) const
+{
+    for(int i = 0 ; i < store.getNumParams() ; i++)
+    {
+        if(std::floor(store.getValue(row, i) / quantisationStep) != std::floor(store.getValue(other, i) / quantisationStep))
+            return false;
+    }
+    return true;
+}
+
+bool TT_Deduplicator::isNearDuplicate(const TT_PatchStore& store, int row, int other) const
+{
+    for(int i = 0 ; i < store.getNumParams() ; i++)
+    {
+        if(std::abs(store.getValue(row, i) - store.getValue(other, i)) > tolerance)
+            return false;
+    }
+    return true;
+}
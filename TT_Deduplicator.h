@@ -0,0 +1,71 @@
+/*
+  ==============================================================================
+
+    TT_Deduplicator.h
+    Created: 18 Oct 2026 3:02:27pm
+    Author:  Matt Twitchen
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "TT_PatchStore.h"
+#include <unordered_map>
+
+/*
+ Collapses duplicate rows of a patch store, per tag.
+ 
+ A row only counts as a duplicate of an earlier row carrying the same tag, the tag bit
+ is cleared from the later row so it drops out of getRowsWithTag(), rows left with no
+ tags are dead. Earlier rows always win so the result doesn't depend on anything but
+ the store order.
+ 
+ Exact duplicates: every value quantised to quantisationStep, rows are bucketed by a
+ hash of the quantised vector and confirmed by comparing the quantised values.
+ 
+ Near duplicates (tolerance > 0): rows within tolerance of each other on every
+ parameter. Each LSH table grids the parameter space with cells of cellScale * tolerance
+ and its own random offset, rows are only compared against rows in the same cell of
+ some table, so a pass is linear in the number of rows. Close rows that straddle a
+ cell edge in every table are missed, more tables makes that less likely.
+ */
+
+class TT_Deduplicator
+{
+public:
+    
+    // rows collapsed per tag, indexed like the store's patchTags
+    struct Result
+    {
+        std::vector<int> numExact;
+        std::vector<int> numNear;
+        
+        int getTotal(int tag) const { return numExact[(size_t)tag] + numNear[(size_t)tag]; }
+    };
+    
+    TT_Deduplicator() {}
+    
+    // 0 only collapses exact duplicates
+    void setTolerance(float newTolerance) { tolerance = juce::jmax(0.0f, newTolerance); }
+    void setQuantisationStep(float newStep) { jassert(newStep > 0); quantisationStep = newStep; }
+    void setNumTables(int newNumTables) { numTables = juce::jmax(1, newNumTables); }
+    
+    float getTolerance() const { return tolerance; }
+    
+    Result process(TT_PatchStore& store, int numTags) const;
+    
+private:
+    
+    typedef std::unordered_map<juce::uint64, std::vector<int>> Buckets;
+    
+    juce::uint64 hashCells(const TT_PatchStore& store, int row, float cellSize, const float* offsets) const;
+    bool isExactDuplicate(const TT_PatchStore& store, int row, int other) const;
+    bool isNearDuplicate(const TT_PatchStore& store, int row, int other) const;
+    
+    float tolerance = 0.0f; // near matching is opt in, it changes which patches are trained on
+    float quantisationStep = 1.0e-4f;
+    int numTables = 4;
+    
+    static constexpr float cellScale = 4.0f; // cell width / tolerance, wider cells = fewer misses but bigger buckets
+    static constexpr juce::int64 offsetSeed = 0x5454; // fixed so repeated runs collapse the same rows
+};
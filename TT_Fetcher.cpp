@@ -16,19 +16,17 @@
 #define spectralTags DataNodes::TagNodes::Spectral::Patch::patchTags
 #define temporalTags DataNodes::TagNodes::Temporal::Patch::patchTags
 
-#define temporalTagsForCheck DataNodes::TagNodes::Temporal::Patch::TagCheck::patchTags
-
 #define spectralParents DataNodes::TagNodes::Spectral::Parents::parentTags
 #define temporalParents DataNodes::TagNodes::Temporal::Parents::parentTags
 
-TT_Fetcher::TT_Fetcher() : patchLibrary("/Users/twitch/TT-Testing/MM2 Library/")
+TT_Fetcher::TT_Fetcher()
 {
-    jassert(patchLibrary.isDirectory() && patchLibrary.exists());
+    setPatchLibrary(juce::File("/Users/twitch/TT-Testing/MM2 Library/"));
 }
 
 TT_Fetcher::~TT_Fetcher()
 {
-    
+    stopWatching();
 }
 
 juce::ValueTree TT_Fetcher::initialiseSpectralTag(juce::Identifier tag)
@@ -51,60 +49,302 @@ juce::ValueTree TT_Fetcher::initialiseTemporalTag(juce::Identifier tag)
     return tagTree;
 }
 
+void TT_Fetcher::setPatchLibrary(const juce::File& library)
+{
+    jassert(library.exists() && (library.isDirectory() || library.hasFileExtension(".zip")));
+    patchLibrary = library;
+    
+    // snapshots live in the app's data folder rather than the user's library, one per library path
+    const juce::String snapshotName = library.getFileNameWithoutExtension() + "_" + juce::String::toHexString(library.getFullPathName().hashCode64());
+    cacheFile = juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+                    .getChildFile("TT").getChildFile("PatchCache").getChildFile(snapshotName + ".bin");
+}
+
+std::vector<TT_Fetcher::LibraryFile> TT_Fetcher::scanLibrary()
+{
+    std::vector<LibraryFile> files;
+    
+    if(isZipLibrary())
+    {
+        // reopened every scan so an updated archive is picked up, entries are read in place without extracting
+        zipFile = std::make_unique<juce::ZipFile>(patchLibrary);
+        
+        for(int i = 0 ; i < zipFile->getNumEntries() ; i++)
+        {
+            const juce::ZipFile::ZipEntry* zipEntry = zipFile->getEntry(i);
+            if(!zipEntry->filename.endsWithIgnoreCase(".xml") || zipEntry->filename.startsWith("__MACOSX"))
+                continue;
+            
+            LibraryFile libraryFile;
+            libraryFile.zipEntry = i;
+            libraryFile.fingerprint.fileName = zipEntry->filename; // path inside the archive
+            libraryFile.fingerprint.size = zipEntry->uncompressedSize;
+            libraryFile.fingerprint.modificationTime = zipEntry->fileTime.toMilliseconds();
+            files.push_back(libraryFile);
+        }
+    } else
+    {
+        juce::Array<juce::File> children;
+        patchLibrary.findChildFiles(children, juce::File::findFiles, false, "*.xml");
+        
+        for(auto& child : children)
+        {
+            LibraryFile libraryFile;
+            libraryFile.file = child;
+            libraryFile.fingerprint.fileName = child.getFileName();
+            libraryFile.fingerprint.size = child.getSize();
+            libraryFile.fingerprint.modificationTime = child.getLastModificationTime().toMilliseconds();
+            files.push_back(libraryFile);
+        }
+    }
+    
+    // directory and archive order isn't guaranteed, keep the store order stable between runs
+    std::sort(files.begin(), files.end(), [] (const LibraryFile& a, const LibraryFile& b)
+    {
+        return a.fingerprint.fileName < b.fingerprint.fileName;
+    });
+    
+    return files;
+}
+
 void TT_Fetcher::parsePatchLibrary()
 {
-    juce::Array<juce::File> files;
-    patchLibrary.findChildFiles(files, juce::File::findFiles, false, "*.xml");
+    const juce::ScopedLock updateScope (updateLock);
+    
+    std::vector<LibraryFile> files = scanLibrary();
     
     DBG("Parsing patch library ...");
-    for(auto& file : files)
+    
+    numCacheHits = 0;
+    numCacheUpdates = 0;
+    numParsed = 0;
+    resetIngestionStats();
+    const juce::int64 startTicks = juce::Time::getHighResolutionTicks();
+    
+    const bool cacheLoaded = useCache && patchCache.load(cacheFile);
+    
+    // files are split into contiguous chunks, each parsed into its own buffer and merged back in chunk order
+    // so the resulting trees match a serial parse no matter how the workers get scheduled
+    const int numFiles = (int)files.size();
+    const int numChunks = juce::jmin(numFiles, numThreads * 4);
+    std::vector<std::vector<ParsedPatch>> chunks (numChunks);
+    
+    Parallel::forEachTask(numChunks, numThreads, [&] (int chunk)
     {
-        parseXML(file);
+        const int first = (int)((juce::int64)numFiles * chunk / numChunks);
+        const int last = (int)((juce::int64)numFiles * (chunk + 1) / numChunks);
+        
+        chunks[chunk].reserve(last - first);
+        for(int i = first ; i < last ; i++)
+            chunks[chunk].push_back(loadPatch(files[(size_t)i]));
+    });
+    
+    // a second parse starts again rather than merging, otherwise files deleted since the first one would keep their rows
+    const juce::ScopedLock sl (libraryLock);
+    
+    manifest.clear();
+    sourceFiles.clear();
+    spectralStore.clear();
+    temporalStore.clear();
+    
+    spectralStore.reserve(numFiles);
+    temporalStore.reserve(numFiles);
+    
+    for(auto& chunk : chunks)
+    {
+        for(auto& patch : chunk)
+            addParsedPatch(patch);
     }
     
-    constructDataTree();
+    DBG("Parsed " << numParsed.load() << " files, " << numCacheHits.load() << " read from cache");
+    
+    if(useDeduplication)
+        deduplicate();
+    
+    updateIngestionStats(startTicks);
+    
+    const bool filesRemoved = cacheLoaded && numCacheHits < patchCache.getNumEntries();
+    patchCache.release();
+    
+    if(useCache && (!cacheLoaded || numParsed > 0 || numCacheUpdates > 0 || filesRemoved))
+        writeCache();
+    
     isParsed = true;
 }
 
-void TT_Fetcher::parseXML(const juce::File& file)
+ParsedPatch TT_Fetcher::loadPatch(const juce::File& file)
+{
+    LibraryFile libraryFile;
+    libraryFile.file = file;
+    libraryFile.fingerprint.fileName = file.getFileName();
+    libraryFile.fingerprint.size = file.getSize();
+    libraryFile.fingerprint.modificationTime = file.getLastModificationTime().toMilliseconds();
+    
+    return loadPatch(libraryFile);
+}
+
+ParsedPatch TT_Fetcher::loadPatch(const LibraryFile& libraryFile)
 {
-    auto xml = juce::XmlDocument(file);
+    const FileFingerprint& fingerprint = libraryFile.fingerprint;
+    
+    const int entry = useCache ? patchCache.findEntry(fingerprint.fileName) : -1;
+    FileFingerprint cached;
+    if(entry >= 0)
+    {
+        cached = patchCache.getFingerprint(entry);
+        if(cached.size == fingerprint.size && cached.modificationTime == fingerprint.modificationTime)
+        {
+            numCacheHits++;
+            return patchCache.getPatch(entry);
+        }
+    }
+    
+    // saved again without any edits, only the fingerprint needs updating
+    if(entry >= 0 && cached.size == fingerprint.size)
+    {
+        ParsedPatch patch = readPatch(libraryFile);
+        if(patch.fingerprint.contentHash == cached.contentHash)
+        {
+            ParsedPatch cachedPatch = patchCache.getPatch(entry);
+            cachedPatch.fingerprint = patch.fingerprint;
+            numCacheHits++;
+            numCacheUpdates++;
+            return cachedPatch;
+        }
+        
+        numParsed++;
+        return patch;
+    }
+    
+    numParsed++;
+    return readPatch(libraryFile);
+}
+
+ParsedPatch TT_Fetcher::readPatch(const LibraryFile& libraryFile)
+{
+    if(libraryFile.zipEntry >= 0)
+        return readZipEntry(libraryFile.zipEntry, libraryFile.fingerprint);
+    
+    return readPatch(libraryFile.file, libraryFile.fingerprint);
+}
+
+ParsedPatch TT_Fetcher::readPatch(const juce::File& file, FileFingerprint fingerprint)
+{
+    const juce::int64 readStart = juce::Time::getHighResolutionTicks();
+    
+    // parse straight out of the mapped pages, the file is never copied into a String or MemoryBlock
+    juce::MemoryMappedFile mappedFile (file, juce::MemoryMappedFile::readOnly);
+    const char* data = static_cast<const char*>(mappedFile.getData());
+    const size_t size = mappedFile.getSize();
+    
+    if(data == nullptr)
+    {
+        jassertfalse;
+        ParsedPatch unreadable;
+        unreadable.fingerprint = fingerprint;
+        return unreadable;
+    }
+    
+    // hashing is the first pass over the mapping, so this is where the pages get faulted in
+    fingerprint.contentHash = TT_PatchCache::hashContent(data, size);
+    
+    const juce::int64 parseStart = juce::Time::getHighResolutionTicks();
+    ParsedPatch patch = parseXML(data, size);
+    patch.fingerprint = fingerprint;
+    
+    bytesRead += (juce::int64)size;
+    readTicks += parseStart - readStart;
+    parseTicks += juce::Time::getHighResolutionTicks() - parseStart;
+    
+    return patch;
+}
+
+ParsedPatch TT_Fetcher::readZipEntry(int zipEntry, FileFingerprint fingerprint)
+{
+    const juce::int64 readStart = juce::Time::getHighResolutionTicks();
+    
+    // a ZipFile opened from a File gives every entry stream its own file handle, so workers can inflate entries concurrently
+    std::unique_ptr<juce::InputStream> stream (zipFile->createStreamForEntry(zipEntry));
+    
+    const size_t size = (size_t)fingerprint.size;
+    juce::HeapBlock<char> data (size);
+    
+    if(stream == nullptr || stream->read(data, (int)size) != (int)size)
+    {
+        jassertfalse;
+        ParsedPatch unreadable;
+        unreadable.fingerprint = fingerprint;
+        return unreadable;
+    }
+    
+    // read time covers inflating the entry as well as hashing it
+    fingerprint.contentHash = TT_PatchCache::hashContent(data, size);
+    
+    const juce::int64 parseStart = juce::Time::getHighResolutionTicks();
+    ParsedPatch patch = parseXML(data, size);
+    patch.fingerprint = fingerprint;
+    
+    bytesRead += (juce::int64)size;
+    readTicks += parseStart - readStart;
+    parseTicks += juce::Time::getHighResolutionTicks() - parseStart;
+    
+    return patch;
+}
+
+void TT_Fetcher::resetIngestionStats()
+{
+    bytesRead = 0;
+    readTicks = 0;
+    parseTicks = 0;
+}
+
+void TT_Fetcher::updateIngestionStats(juce::int64 startTicks)
+{
+    ingestionStats.bytesRead = bytesRead;
+    ingestionStats.readSeconds = juce::Time::highResolutionTicksToSeconds(readTicks);
+    ingestionStats.parseSeconds = juce::Time::highResolutionTicksToSeconds(parseTicks);
+    ingestionStats.wallSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+    
+    DBG("Ingested " << ingestionStats.bytesRead << " bytes in " << ingestionStats.wallSeconds << "s ("
+        << ingestionStats.getBytesPerSecond() / 1.0e6 << " MB/s)");
+    DBG("Read " << ingestionStats.getReadBytesPerSecond() / 1.0e6 << " MB/s, parse "
+        << ingestionStats.getParseBytesPerSecond() / 1.0e6 << " MB/s per worker");
+}
+
+ParsedPatch TT_Fetcher::parseXML(const char* data, size_t size)
+{
+    if(!useStreamingParser)
+        return parseXMLDocument(data, size);
+    
+    return parseXMLStream(data, size);
+}
+
+ParsedPatch TT_Fetcher::parseXMLDocument(const char* data, size_t size)
+{
+    ParsedPatch patch;
+    
+    auto xml = juce::XmlDocument(juce::String::fromUTF8(data, (int)size));
     std::unique_ptr<juce::XmlElement> root = xml.getDocumentElement();
     jassert(root != nullptr);
     
-    juce::XmlElement* parameterNode;
-    juce::XmlElement* macroNode;
+    if(root == nullptr)
+        return patch;
+    
+    juce::XmlElement* parameterNode = nullptr;
+    juce::XmlElement* macroNode = nullptr;
     
     for(auto* node : root->getChildIterator())
     {
         juce::String nodeName = node->getTagName();
         if(nodeName == "metadata")
         {
-            juce::String name = node->getStringAttribute("name");
-            DBG("Parsing " << name << " ...");
+            patch.name = node->getStringAttribute("name");
+            DBG("Parsing " << patch.name << " ...");
             juce::String timbre = node->getStringAttribute("timbres");
-            for(int i = 0 ; i < spectralTags.size() ; i++)
-            {
-                juce::String toCheck = spectralTags[i].toString();
-                if(timbre.contains(toCheck))
-                {
-                    if(!spectralTagsToFetch.contains(toCheck))
-                        spectralTagsToFetch.add(toCheck);
-                }
-            }
+            TagTable::classify(timbre.toRawUTF8(), false, patch.spectralTagMask);
             
             juce::String type = node->getStringAttribute("types");
-            DBG("type = " << type);
-            for(int i = 0 ; i < temporalTags.size() ; i++)
-            {
-                juce::String toCheck = temporalTagsForCheck[i];
-                if(type.contains(toCheck))
-                {
-                    DBG("contains = " << toCheck);
-                    if(!temporalTagsToFetch.contains(toCheck))
-                        temporalTagsToFetch.add(toCheck);
-                }
-            }
+            TagTable::classify(type.toRawUTF8(), true, patch.temporalTagMask);
         } else if(nodeName == "parameter_data")
         {
             parameterNode = node;
@@ -113,102 +353,355 @@ void TT_Fetcher::parseXML(const juce::File& file)
             macroNode = node;
         }
     }
-    parseParameterData(parameterNode, macroNode);
+    
+    jassert(parameterNode != nullptr && macroNode != nullptr);
+    
+    if(parameterNode != nullptr && macroNode != nullptr)
+        parseParameterData(parameterNode, macroNode, patch);
+    
+    return patch;
 }
 
-void TT_Fetcher::parseParameterData(juce::XmlElement* parameterNode, juce::XmlElement* macroNode)
+ParsedPatch TT_Fetcher::parseXMLStream(const char* data, size_t size)
 {
-    if(!spectralTagsToFetch.isEmpty())
+    ParsedPatch patch;
+    
+    enum Section
+    {
+        None = 0,
+        Parameters,
+        Macros
+    };
+    
+    TT_XmlStreamReader reader (data, size);
+    Section section = None;
+    bool foundParameters = false;
+    bool foundMacros = false;
+    ParameterFlags isSet {};
+    
+    // macro_data can come before parameter_data, routes are applied once every value has been read
+    TT_MacroRouting routing;
+    
+    for(auto event = reader.next() ; event != TT_XmlStreamReader::EndOfDocument ; event = reader.next())
     {
-        for(int i = 0 ; i < spectralTagsToFetch.size() ; i++)
+        if(event == TT_XmlStreamReader::Error)
         {
-            for(int j = 0 ; j < spectralTags.size() ; j++)
+            jassertfalse;
+            return {};
+        }
+        
+        const int depth = reader.getDepth();
+        
+        if(event == TT_XmlStreamReader::EndElement)
+        {
+            if(depth == 1)
+                section = None;
+            continue;
+        }
+        
+        if(depth == 1)
+        {
+            std::string_view nodeName = reader.getTagName();
+            if(nodeName == "metadata")
             {
-                if(spectralTagsToFetch[i] == spectralTags[j].toString())
-                {
-                    juce::ValueTree nodeTree {spectralTags[j]};
-                    for(int k = 0 ; k < spectralParams.size() ; k++)
-                    {
-                        juce::XmlElement* child = parameterNode->getChildByAttribute("id", spectralParams[k].toString());
-                        float value = child->getDoubleAttribute("value");
-                        nodeTree.setProperty(spectralParams[k], value, nullptr);
-                    }
-                    
-                    for(auto* node : macroNode->getChildIterator())
-                    {
-                        for(auto* childNode : node->getChildIterator())
-                        {
-                            for(int k = 0 ; k < spectralParams.size() ; k++)
-                            {
-                                if(childNode->getStringAttribute("id") == spectralParams[k].toString())
-                                {
-                                    float value = node->getDoubleAttribute("amount");
-                                    addMacroToProperty(nodeTree, spectralParams[k], value);
-                                }
-                            }
-                        }
-                    }
-                    
-                    fetchParentTree(spectralParents[j]).addChild(nodeTree, spectralIndex, nullptr);
-                    spectralIndex++;
-                }
+                std::string_view name = reader.getAttribute("name");
+                patch.name = juce::String::fromUTF8(name.data(), (int)name.size());
+                
+                TagTable::classify(reader.getAttribute("timbres"), false, patch.spectralTagMask);
+                TagTable::classify(reader.getAttribute("types"), true, patch.temporalTagMask);
+            } else if(nodeName == "parameter_data")
+            {
+                section = Parameters;
+                foundParameters = true;
+            } else if(nodeName == "macro_data")
+            {
+                section = Macros;
+                foundMacros = true;
             }
+        } else if(section == Parameters && depth == 2)
+        {
+            const int id = ParameterIDs::intern(reader.getAttribute("id"));
+            if(id >= 0)
+                setParameterValue(patch, id, reader.getFloatAttribute("value"), isSet);
+        } else if(section == Macros && depth == 2)
+        {
+            routing.beginMacro(reader.getFloatAttribute("amount"));
+        } else if(section == Macros && depth == 3)
+        {
+            const int id = ParameterIDs::intern(reader.getAttribute("id"));
+            if(reader.hasAttribute("amount"))
+                routing.addRoute(id, reader.getFloatAttribute("amount"));
+            else
+                routing.addRoute(id);
+        }
+    }
+    
+    jassert(foundParameters && foundMacros);
+    
+    if(!foundParameters || !foundMacros)
+        return patch;
+    
+    routing.apply(patch);
+    
+    patch.isValid = true;
+    return patch;
+}
+
+void TT_Fetcher::parseParameterData(juce::XmlElement* parameterNode, juce::XmlElement* macroNode, ParsedPatch& patch)
+{
+    ParameterFlags isSet {};
+    for(auto* child : parameterNode->getChildIterator())
+    {
+        const int id = ParameterIDs::intern(child->getStringAttribute("id").toRawUTF8());
+        if(id >= 0)
+            setParameterValue(patch, id, (float)child->getDoubleAttribute("value"), isSet);
+    }
+    
+    TT_MacroRouting routing;
+    for(auto* node : macroNode->getChildIterator())
+    {
+        routing.beginMacro((float)node->getDoubleAttribute("amount"));
+        
+        for(auto* childNode : node->getChildIterator())
+        {
+            const int id = ParameterIDs::intern(childNode->getStringAttribute("id").toRawUTF8());
+            if(childNode->hasAttribute("amount"))
+                routing.addRoute(id, (float)childNode->getDoubleAttribute("amount"));
+            else
+                routing.addRoute(id);
+        }
+    }
+    
+    routing.apply(patch);
+    patch.isValid = true;
+}
+
+void TT_Fetcher::setParameterValue(ParsedPatch& patch, int parameterID, float value, ParameterFlags& isSet)
+{
+    if(isSet[(size_t)parameterID])
+        return;
+    
+    isSet[(size_t)parameterID] = true;
+    
+    const int spectral = ParameterIDs::getSpectralIndex(parameterID);
+    if(spectral >= 0)
+        patch.spectralValues[(size_t)spectral] = value;
+    
+    const int temporal = ParameterIDs::getTemporalIndex(parameterID);
+    if(temporal >= 0)
+        patch.temporalValues[(size_t)temporal] = value;
+}
+
+void TT_Fetcher::addParsedPatch(const ParsedPatch& patch)
+{
+    ManifestEntry& entry = manifest[patch.fingerprint.fileName];
+    
+    if(entry.sourceFile == TT_PatchStore::noSourceFile)
+    {
+        entry.sourceFile = sourceFiles.size();
+        sourceFiles.add(patch.fingerprint.fileName);
+    }
+    
+    updateRows(entry, patch);
+}
+
+LibraryDelta TT_Fetcher::updatePatchLibrary()
+{
+    jassert(isParsed);
+    
+    // a manual update and the watcher's would both reopen zipFile and read the manifest, only one runs at a time.
+    // libraryLock is only taken once the files are read so the stores stay readable meanwhile
+    const juce::ScopedLock updateScope (updateLock);
+    
+    std::vector<LibraryFile> files = scanLibrary();
+    
+    // only files whose size or modification time moved are read again
+    std::vector<LibraryFile> changedFiles;
+    std::map<juce::String, bool> seen;
+    
+    for(auto& file : files)
+    {
+        const FileFingerprint& fingerprint = file.fingerprint;
+        seen[fingerprint.fileName] = true;
+        
+        auto found = manifest.find(fingerprint.fileName);
+        if(found != manifest.end())
+        {
+            const FileFingerprint& previous = found->second.patch.fingerprint;
+            if(previous.size == fingerprint.size && previous.modificationTime == fingerprint.modificationTime)
+                continue;
         }
-        spectralTagsToFetch.clear();
+        
+        changedFiles.push_back(file);
     }
-       
-    // check vector size
-    if(!temporalTagsToFetch.isEmpty())
+    
+    std::vector<ParsedPatch> changedPatches (changedFiles.size());
+    Parallel::forEachTask((int)changedFiles.size(), numThreads, [&] (int i)
+    {
+        changedPatches[(size_t)i] = readPatch(changedFiles[(size_t)i]);
+    });
+    
+    LibraryDelta delta;
+    bool fingerprintsChanged = false;
+    
+    const juce::ScopedLock sl (libraryLock);
+    
+    for(auto& patch : changedPatches)
     {
-        for(int i = 0 ; i < temporalTagsToFetch.size() ; i++)
+        auto found = manifest.find(patch.fingerprint.fileName);
+        if(found != manifest.end())
         {
-            for(int j = 0 ; j < temporalTags.size() ; j++)
+            ManifestEntry& entry = found->second;
+            
+            // touched without being edited
+            if(entry.patch.fingerprint.contentHash == patch.fingerprint.contentHash)
             {
-                if(temporalTagsToFetch[i] == temporalTagsForCheck[j])
-                {
-                    juce::ValueTree nodeTree {temporalTags[j]};
-                    for(int k = 0 ; k < temporalParams.size() ; k++)
-                    {
-                        juce::XmlElement* child = parameterNode->getChildByAttribute("id", temporalParams[k].toString());
-                        float value = child->getDoubleAttribute("value");
-                        nodeTree.setProperty(temporalParams[k], value, nullptr);
-                    }
-                    fetchParentTree(temporalParents[j]).addChild(nodeTree, temporalIndex, nullptr);
-                    temporalIndex++;
-                    
-                    for(auto* node : macroNode->getChildIterator())
-                    {
-                        for(auto* childNode : node->getChildIterator())
-                        {
-                            for(int k = 0 ; k < temporalParams.size() ; k++)
-                            {
-                                if(childNode->getStringAttribute("id") == temporalParams[k].toString())
-                                {
-                                    float value = node->getDoubleAttribute("amount");
-                                    addMacroToProperty(nodeTree, temporalParams[k], value);
-                                }
-                            }
-                        }
-                    }
-                }
+                entry.patch.fingerprint = patch.fingerprint;
+                fingerprintsChanged = true;
+                continue;
             }
+            
+            delta.removed.push_back(entry.patch);
+        }
+        
+        delta.added.push_back(patch);
+        addParsedPatch(patch);
+    }
+    
+    for(auto it = manifest.begin() ; it != manifest.end() ;)
+    {
+        if(seen.count(it->first) == 0)
+        {
+            delta.removed.push_back(it->second.patch);
+            removeRows(it->second);
+            it = manifest.erase(it);
+        } else
+        {
+            it++;
         }
-        temporalTagsToFetch.clear();
     }
+    
+    if(!delta.removed.empty())
+        compactStores();
+    
+    // removing or editing a file can bring back a row that duplicated it
+    if(useDeduplication && !delta.isEmpty())
+        deduplicate();
+    
+    if(!delta.isEmpty() || fingerprintsChanged)
+    {
+        DBG("Library update: " << (int)delta.added.size() << " added, " << (int)delta.removed.size() << " removed");
+        
+        if(useCache)
+            writeCache();
+    }
+    
+    if(!delta.isEmpty() && onLibraryChanged != nullptr)
+        onLibraryChanged(delta);
+    
+    return delta;
+}
+
+void TT_Fetcher::startWatching(int intervalMs)
+{
+    stopWatching();
+    
+    watcher = std::make_unique<Watcher>(*this, intervalMs);
+    watcher->startThread();
+}
+
+void TT_Fetcher::stopWatching()
+{
+    if(watcher == nullptr)
+        return;
+    
+    watcher->signalThreadShouldExit();
+    watcher->notify();
+    watcher->stopThread(5000);
+    watcher = nullptr;
+}
+
+void TT_Fetcher::updateRows(ManifestEntry& entry, const ParsedPatch& patch)
+{
+    const juce::uint32 spectralMask = patch.isValid ? patch.spectralTagMask : 0;
+    const juce::uint32 temporalMask = patch.isValid ? patch.temporalTagMask : 0;
+    
+    // replaced files keep their rows, untagged rows are left dead until the stores are compacted
+    if(spectralMask != 0 && entry.spectralRow < 0)
+        entry.spectralRow = spectralStore.addRow(patch.spectralValues.data(), spectralMask, entry.sourceFile);
+    else if(entry.spectralRow >= 0)
+        spectralStore.setRow(entry.spectralRow, patch.spectralValues.data(), spectralMask, entry.sourceFile);
+    
+    if(temporalMask != 0 && entry.temporalRow < 0)
+        entry.temporalRow = temporalStore.addRow(patch.temporalValues.data(), temporalMask, entry.sourceFile);
+    else if(entry.temporalRow >= 0)
+        temporalStore.setRow(entry.temporalRow, patch.temporalValues.data(), temporalMask, entry.sourceFile);
+    
+    entry.patch = patch;
+}
+
+void TT_Fetcher::removeRows(ManifestEntry& entry)
+{
+    ParsedPatch removed = entry.patch;
+    removed.isValid = false;
+    updateRows(entry, removed);
+}
+
+void TT_Fetcher::compactStores()
+{
+    std::vector<int> spectralRemap = spectralStore.compact();
+    std::vector<int> temporalRemap = temporalStore.compact();
+    
+    for(auto& [fileName, entry] : manifest)
+    {
+        if(entry.spectralRow >= 0)
+            entry.spectralRow = spectralRemap[(size_t)entry.spectralRow];
+        
+        if(entry.temporalRow >= 0)
+            entry.temporalRow = temporalRemap[(size_t)entry.temporalRow];
+    }
+}
+
+void TT_Fetcher::deduplicate()
+{
+    // start from every row's full tag mask, rows that lost all their tags last time get added back
+    for(auto& [fileName, entry] : manifest)
+        updateRows(entry, entry.patch);
+    
+    spectralDuplicates = deduplicator.process(spectralStore, spectralTags.size());
+    temporalDuplicates = deduplicator.process(temporalStore, temporalTags.size());
+    
+    for(int i = 0 ; i < spectralTags.size() ; i++)
+    {
+        if(spectralDuplicates.getTotal(i) > 0)
+            DBG(spectralTags[i].toString() << ": " << spectralDuplicates.numExact[(size_t)i] << " exact, " << spectralDuplicates.numNear[(size_t)i] << " near duplicates collapsed");
+    }
+    
+    for(int i = 0 ; i < temporalTags.size() ; i++)
+    {
+        if(temporalDuplicates.getTotal(i) > 0)
+            DBG(temporalTags[i].toString() << ": " << temporalDuplicates.numExact[(size_t)i] << " exact, " << temporalDuplicates.numNear[(size_t)i] << " near duplicates collapsed");
+    }
+}
+
+void TT_Fetcher::writeCache()
+{
+    std::vector<const ParsedPatch*> patches;
+    patches.reserve(manifest.size());
+    
+    for(auto& [fileName, entry] : manifest)
+        patches.push_back(&entry.patch);
+    
+    if(!TT_PatchCache::write(cacheFile, patches))
+        DBG("Failed to write patch cache to " << cacheFile.getFullPathName());
 }
 
-void TT_Fetcher::constructDataTree()
+juce::ValueTree TT_Fetcher::constructDataTree() const
 {
-    spectralTree.addChild(brightParent, 0, nullptr);
-    spectralTree.addChild(darkParent, 1, nullptr);
-    spectralTree.addChild(resonantParent, 2, nullptr);
-    spectralTree.addChild(softParent, 3, nullptr);
+    juce::ValueTree dataTree {DataNodes::Data};
     
-    temporalTree.addChild(pluckParent, 0, nullptr);
-    temporalTree.addChild(longRelParent, 1, nullptr);
-    temporalTree.addChild(swellParent, 2, nullptr);
-    temporalTree.addChild(shortParent, 3, nullptr);
+    dataTree.appendChild(spectralStore.createValueTree(DataNodes::TypeNodes::Spectral, spectralParents, spectralTags, spectralParams), nullptr);
+    dataTree.appendChild(temporalStore.createValueTree(DataNodes::TypeNodes::Temporal, temporalParents, temporalTags, temporalParams), nullptr);
     
-    dataTree.addChild(spectralTree, 0, nullptr);
-    dataTree.addChild(temporalTree, 1, nullptr);
+    return dataTree;
 }
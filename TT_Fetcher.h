@@ -10,6 +10,16 @@
 
 #pragma once
 #include "TT_DataNodes.h"
+#include "TT_Deduplicator.h"
+#include "TT_MacroRouting.h"
+#include "TT_Parallel.h"
+#include "TT_ParsedPatch.h"
+#include "TT_PatchCache.h"
+#include "TT_PatchStore.h"
+#include "TT_TagTable.h"
+#include "TT_XmlStreamReader.h"
+#include <atomic>
+#include <map>
 
 /*
  TO DO:
@@ -25,6 +35,28 @@
  
  */
 
+// what changed in the library since the last parse or update, old versions of replaced files are in removed
+struct LibraryDelta
+{
+    std::vector<ParsedPatch> added;
+    std::vector<ParsedPatch> removed;
+    
+    bool isEmpty() const { return added.empty() && removed.empty(); }
+};
+
+// throughput of the last parse, compare read and parse rates to see whether ingestion is I/O or CPU bound
+struct IngestionStats
+{
+    juce::int64 bytesRead = 0;
+    double readSeconds = 0;  // mapping files and the first pass over their pages, summed over workers
+    double parseSeconds = 0; // parsing already resident pages, summed over workers
+    double wallSeconds = 0;
+    
+    double getReadBytesPerSecond() const { return readSeconds > 0 ? bytesRead / readSeconds : 0; }
+    double getParseBytesPerSecond() const { return parseSeconds > 0 ? bytesRead / parseSeconds : 0; }
+    double getBytesPerSecond() const { return wallSeconds > 0 ? bytesRead / wallSeconds : 0; }
+};
+
 class TT_Fetcher
 {
 public:
@@ -35,72 +67,146 @@ public:
     juce::ValueTree initialiseSpectralTag(juce::Identifier tag); // returns an instance of a spectral tag
     juce::ValueTree initialiseTemporalTag(juce::Identifier tag); // returns an instance of a temporal tag
     
-    void parsePatchLibrary();
-    void parseXML(const juce::File& file);
-    void parseParameterData(juce::XmlElement* parameterNode, juce::XmlElement* macroNode);
+    // a directory of patch files or a .zip of them, archives are parsed in place without extracting
+    void setPatchLibrary(const juce::File& library);
+    bool isZipLibrary() const { return patchLibrary.hasFileExtension(".zip"); }
     
-    void constructDataTree();
-    std::shared_ptr<juce::ValueTree> getDataTree() { return std::make_shared<juce::ValueTree>(dataTree); }
+    // rebuilds the stores from scratch, files removed since an earlier parse are dropped
+    void parsePatchLibrary();
+    ParsedPatch loadPatch(const juce::File& file); // cached copy if the file is unchanged, otherwise parses it
+    ParsedPatch parseXML(const char* data, size_t size); // thread safe, doesn't touch the data tree
+    ParsedPatch parseXMLDocument(const char* data, size_t size); // builds a full juce::XmlDocument DOM
+    ParsedPatch parseXMLStream(const char* data, size_t size); // single forward pass, no DOM
+    void parseParameterData(juce::XmlElement* parameterNode, juce::XmlElement* macroNode, ParsedPatch& patch);
+    void addParsedPatch(const ParsedPatch& patch); // adds a row to the spectral and/or temporal store
+    
+    // rescans the library and only adds, replaces or removes the rows of files that changed since the last scan
+    LibraryDelta updatePatchLibrary();
+    
+    // polls the library on a background thread, onLibraryChanged is called from that thread with each non empty delta
+    void startWatching(int intervalMs = 2000);
+    void stopWatching();
+    std::function<void(const LibraryDelta&)> onLibraryChanged;
+    
+    // held while the watcher modifies the stores, lock it before reading them while watching
+    const juce::CriticalSection& getLibraryLock() const { return libraryLock; }
+    
+    // number of workers used by parsePatchLibrary, 1 parses serially on the calling thread
+    void setNumThreads(int newNumThreads) { numThreads = juce::jmax(1, newNumThreads); }
+    // streaming is the default, the DOM parser is kept as a reference for checking the streamed values
+    void setUseStreamingParser(bool shouldStream) { useStreamingParser = shouldStream; }
+    // binary snapshot of the parsed library, unchanged files are read from it instead of being reparsed
+    void setUseCache(bool shouldUseCache) { useCache = shouldUseCache; }
+    void setCacheFile(const juce::File& newCacheFile) { cacheFile = newCacheFile; }
+    // off by default, when on duplicate rows are collapsed per tag after every parse and update,
+    // the default tolerance of 0 only collapses exact duplicates
+    void setUseDeduplication(bool shouldDeduplicate) { useDeduplication = shouldDeduplicate; }
+    void setDuplicateTolerance(float newTolerance) { deduplicator.setTolerance(newTolerance); }
+    
+    // one row per patch, tag masks index the Spectral / Temporal patchTags arrays
+    const TT_PatchStore& getSpectralStore() const { return spectralStore; }
+    const TT_PatchStore& getTemporalStore() const { return temporalStore; }
+    const juce::StringArray& getSourceFiles() const { return sourceFiles; }
+    
+    // ValueTree copy of the stores for the GUI and debugging, the pipeline doesn't use it
+    juce::ValueTree constructDataTree() const;
+    std::shared_ptr<juce::ValueTree> getDataTree() const { return std::make_shared<juce::ValueTree>(constructDataTree()); }
     
     bool getState() { return isParsed; }
+    IngestionStats getIngestionStats() const { return ingestionStats; }
+    const TT_Deduplicator::Result& getSpectralDuplicates() const { return spectralDuplicates; }
+    const TT_Deduplicator::Result& getTemporalDuplicates() const { return temporalDuplicates; }
     
 private:
     
-    juce::ValueTree fetchParentTree(juce::Identifier toFetch)
+    typedef std::array<bool, ParameterIDs::maxIDs> ParameterFlags;
+    
+    // the first value of an id listed twice wins, the same as the old getChildByAttribute lookup
+    static void setParameterValue(ParsedPatch& patch, int parameterID, float value, ParameterFlags& isSet);
+    
+    // a patch in the library, a file in the directory or an entry of the archive
+    struct LibraryFile
     {
-        for(int i = 0 ; i < parents.size() ; i++)
-        {
-            if(parents[i].hasType(toFetch))
-                return parents[i];
-        }
-    }
+        juce::File file;
+        int zipEntry = -1;
+        FileFingerprint fingerprint; // without the content hash
+    };
     
-    void addMacroToProperty(juce::ValueTree tree, juce::Identifier paramID, float valueToAdd)
+    // rows a library file owns in the stores, -1 if it has no tags of that type
+    struct ManifestEntry
+    {
+        ParsedPatch patch;
+        int sourceFile = TT_PatchStore::noSourceFile;
+        int spectralRow = -1;
+        int temporalRow = -1;
+    };
+    
+    std::vector<LibraryFile> scanLibrary();
+    ParsedPatch loadPatch(const LibraryFile& libraryFile);
+    ParsedPatch readPatch(const LibraryFile& libraryFile);
+    ParsedPatch readPatch(const juce::File& file, FileFingerprint fingerprint);
+    ParsedPatch readZipEntry(int zipEntry, FileFingerprint fingerprint);
+    void resetIngestionStats();
+    void updateIngestionStats(juce::int64 startTicks);
+    void updateRows(ManifestEntry& entry, const ParsedPatch& patch);
+    void removeRows(ManifestEntry& entry);
+    void compactStores();
+    void deduplicate();
+    void writeCache();
+    
+    class Watcher : public juce::Thread
     {
-        float value = (float)tree.getProperty(paramID) + valueToAdd;
+    public:
         
-        if(value > 1)
-            value = 1.f;
+        Watcher(TT_Fetcher& ttf, int interval) : juce::Thread("TT_Fetcher Watcher"), fetcher(ttf), intervalMs(interval) {}
         
-        tree.setProperty(paramID, value, nullptr);
-    }
+        void run() override
+        {
+            while(!threadShouldExit())
+            {
+                wait(intervalMs);
+                
+                if(!threadShouldExit())
+                    fetcher.updatePatchLibrary();
+            }
+        }
+        
+    private:
+        
+        TT_Fetcher& fetcher;
+        int intervalMs;
+    };
     
-    void sortTree(juce::ValueTree treeToSort)
-    {
-        treeToSort.sort(sorter, nullptr, false);
-    }
+    std::map<juce::String, ManifestEntry> manifest; // keyed by file name
+    std::unique_ptr<Watcher> watcher;
+    juce::CriticalSection libraryLock;
+    juce::CriticalSection updateLock; // held for a whole parse or update, they share zipFile and the manifest
     
     juce::File patchLibrary;
-    
-    juce::ValueTree dataTree {DataNodes::Data};
-    juce::ValueTree spectralTree {DataNodes::TypeNodes::Spectral};
-    juce::ValueTree temporalTree {DataNodes::TypeNodes::Temporal};
-    
-    juce::ValueTree brightParent {DataNodes::TagNodes::Spectral::Parents::BrightParent};
-    juce::ValueTree darkParent {DataNodes::TagNodes::Spectral::Parents::DarkParent};
-    juce::ValueTree resonantParent {DataNodes::TagNodes::Spectral::Parents::ResonantParent};
-    juce::ValueTree softParent {DataNodes::TagNodes::Spectral::Parents::SoftParent};
-    
-    juce::ValueTree pluckParent {DataNodes::TagNodes::Temporal::Parents::PluckParent};
-    juce::ValueTree longRelParent {DataNodes::TagNodes::Temporal::Parents::LongReleaseParent};
-    juce::ValueTree swellParent {DataNodes::TagNodes::Temporal::Parents::SwellParent};
-    juce::ValueTree shortParent {DataNodes::TagNodes::Temporal::Parents::ShortParent};
-    
-    juce::Array<juce::ValueTree> parents = {brightParent, darkParent, resonantParent, softParent,
-                                            pluckParent, longRelParent, swellParent, shortParent};
-    
-    juce::Array<juce::String> spectralTagsToFetch;
-    juce::Array<juce::String> temporalTagsToFetch;
-    
-    int spectralIndex = 0;
-    int temporalIndex = 0;
+    std::unique_ptr<juce::ZipFile> zipFile; // open while the library is a .zip
+    juce::File cacheFile;
+    TT_PatchCache patchCache;
+    
+    TT_PatchStore spectralStore {DataNodes::ParameterNodes::numSpectralParams};
+    TT_PatchStore temporalStore {DataNodes::ParameterNodes::numTemporalParams};
+    juce::StringArray sourceFiles; // indexed by the stores' source file column
+    
+    TT_Deduplicator deduplicator;
+    TT_Deduplicator::Result spectralDuplicates;
+    TT_Deduplicator::Result temporalDuplicates;
+    
+    int numThreads = Parallel::defaultNumThreads();
+    bool useStreamingParser = true;
+    bool useCache = true;
+    bool useDeduplication = false;
+    
+    std::atomic<int> numCacheHits {0};
+    std::atomic<int> numCacheUpdates {0}; // touched but unchanged files, the snapshot needs their new fingerprint
+    std::atomic<int> numParsed {0};
+    
+    std::atomic<juce::int64> bytesRead {0};
+    std::atomic<juce::int64> readTicks {0};
+    std::atomic<juce::int64> parseTicks {0};
+    IngestionStats ingestionStats;
     bool isParsed = false;
-    
-    struct Sorter
-    {
-        int compareElements (const juce::ValueTree& first, const juce::ValueTree& second)
-        {
-            return first.getProperty ("text").toString().compare (second.getProperty ("text").toString());
-        }
-    } sorter;
 };
@@ -19,16 +19,22 @@
 #define spectralParents DataNodes::TagNodes::Spectral::Parents::parentTags
 #define temporalParents DataNodes::TagNodes::Temporal::Parents::parentTags
 
+// one-hot label for each tag, indexed the same as the Spectral / Temporal patchTags arrays
+static const tensor_t spectralLabels = {{1, 0, 0, 0, 0},  // Bright
+                                        {0, 1, 0, 0, 0},  // Dark
+                                        {0, 0, 1, 0, 0},  // Resonant
+                                        {0, 0, 0, 1, 0}}; // Soft
+
+static const tensor_t temporalLabels = {{0, 0, 0, 1, 0, 0, 0, 0, 0},  // Pluck
+                                        {0, 0, 1, 0, 0, 0, 0, 0, 0},  // Long Release
+                                        {0, 1, 0, 0, 0, 0, 0, 0, 0},  // Swell
+                                        {1, 0, 0, 0, 0, 0, 0, 0, 0}}; // Short
+
 TT_Formatter::TT_Formatter(TT_Augmenter* tta)
 {
     augmenter = tta;
     jassert(augmenter != nullptr);
     // add state check here
-    dataTree = augmenter->getDataTree();
-    jassert(dataTree != nullptr);
-    
-    spectralTree = dataTree->getChildWithName(DataNodes::TypeNodes::Spectral);
-    temporalTree = dataTree->getChildWithName(DataNodes::TypeNodes::Temporal);
 }
 
 TT_Formatter::~TT_Formatter()
@@ -36,172 +42,157 @@ TT_Formatter::~TT_Formatter()
     
 }
 
-void TT_Formatter::formatSpectralData()
+const tensor_t& TT_Formatter::getSpectralLabels()
 {
-    juce::ValueTree brightParent = spectralTree.getChildWithName(DataNodes::TagNodes::Spectral::Parents::BrightParent);
-    for(int i = 0 ; i < brightParent.getNumChildren() ; i++)
-    {
-        juce::ValueTree child = brightParent.getChild(i);
-        vec_t childData;
-        for(int j = 0 ; j < spectralParams.size() ; j++)
-        {
-            childData.push_back(child.getProperty(spectralParams[j]));
-        }
-        spectralData.data.push_back(childData);
-
-        vec_t encodedLabel = {1, 0 , 0 , 0, 0};
-        spectralData.labels.push_back(encodedLabel);
-    }
-    
-    juce::ValueTree darkParent = spectralTree.getChildWithName(DataNodes::TagNodes::Spectral::Parents::DarkParent);
-    for(int i = 0 ; i < darkParent.getNumChildren() ; i++)
-    {
-        juce::ValueTree child = darkParent.getChild(i);
-        vec_t childData;
-        for(int j = 0 ; j < spectralParams.size() ; j++)
-        {
-            childData.push_back(child.getProperty(spectralParams[j]));
-        }
-        spectralData.data.push_back(childData);
-
-        vec_t encodedLabel = {0, 1, 0, 0, 0};
-        spectralData.labels.push_back(encodedLabel);
-    }
-    
-    juce::ValueTree resonantParent = spectralTree.getChildWithName(DataNodes::TagNodes::Spectral::Parents::ResonantParent);
-    for(int i = 0 ; i < resonantParent.getNumChildren() ; i++)
-    {
-        juce::ValueTree child = resonantParent.getChild(i);
-        vec_t childData;
-        for(int j = 0 ; j < spectralParams.size() ; j++)
-        {
-            childData.push_back(child.getProperty(spectralParams[j]));
-        }
-        spectralData.data.push_back(childData);
+    return spectralLabels;
+}
 
-        vec_t encodedLabel = {0, 0, 1, 0, 0};
-        spectralData.labels.push_back(encodedLabel);
-    }
-    
-    juce::ValueTree softParent = spectralTree.getChildWithName(DataNodes::TagNodes::Spectral::Parents::SoftParent);
-    for(int i = 0 ; i < softParent.getNumChildren() ; i++)
-    {
-        juce::ValueTree child = softParent.getChild(i);
-        vec_t childData;
-        for(int j = 0 ; j < spectralParams.size() ; j++)
-        {
-            childData.push_back(child.getProperty(spectralParams[j]));
-        }
-        spectralData.data.push_back(childData);
+const tensor_t& TT_Formatter::getTemporalLabels()
+{
+    return temporalLabels;
+}
 
-        vec_t encodedLabel = {0, 0, 0, 1, 0};
-        spectralData.labels.push_back(encodedLabel);
-    }
+void TT_Formatter::formatSpectralData()
+{
+    formatDataset(augmenter->getSpectralDataset(), spectralLabels, spectralData);
 }
 
 void TT_Formatter::formatTemporalData()
 {
-    juce::ValueTree pluckParent = temporalTree.getChildWithName(DataNodes::TagNodes::Temporal::Parents::PluckParent);
-    for(int i = 0 ; i < pluckParent.getNumChildren() ; i++)
-    {
-        juce::ValueTree child = pluckParent.getChild(i);
-        vec_t childData;
-        for(int j = 1 ; j < temporalParams.size() ; j++)
-        {
-            childData.push_back(child.getProperty(temporalParams[j]));
-        }
-        temporalData.data.push_back(childData);
+    formatDataset(augmenter->getTemporalDataset(), temporalLabels, temporalData);
+}
 
-        vec_t encodedLabel = {0, 0, 0, 1, 0, 0, 0, 0, 0};
-        temporalData.labels.push_back(encodedLabel);
+void TT_Formatter::formatDataset(const TT_PatchStore& dataset, const tensor_t& tagLabels, FormattedData& output)
+{
+    const int numTags = (int)tagLabels.size();
+    const int numParams = dataset.getNumParams();
+    
+    // a row is written once for every tag it carries, count them all first so the output is sized once
+    std::vector<int> tagOffsets ((size_t)numTags + 1, 0);
+    for(int row = 0 ; row < dataset.getNumRows() ; row++)
+    {
+        for(int tag = 0 ; tag < numTags ; tag++)
+            tagOffsets[(size_t)tag + 1] += dataset.hasTag(row, tag) ? 1 : 0;
     }
     
-    juce::ValueTree longReleaseParent = temporalTree.getChildWithName(DataNodes::TagNodes::Temporal::Parents::LongReleaseParent);
-    for(int i = 0 ; i < longReleaseParent.getNumChildren() ; i++)
+    for(int tag = 0 ; tag < numTags ; tag++)
+        tagOffsets[(size_t)tag + 1] += tagOffsets[(size_t)tag];
+    
+    const int numRows = tagOffsets.back();
+    output.allocate(numRows, numParams, tagLabels);
+    
+    // grouped by tag so the unscrambled order matches the parent order
+    std::vector<int> sourceRows ((size_t)numRows);
+    std::vector<int> nextRow (tagOffsets.begin(), tagOffsets.end() - 1);
+    for(int row = 0 ; row < dataset.getNumRows() ; row++)
     {
-        juce::ValueTree child = longReleaseParent.getChild(i);
-        vec_t childData;
-        for(int j = 1 ; j < temporalParams.size() ; j++)
+        for(int tag = 0 ; tag < numTags ; tag++)
         {
-            childData.push_back(child.getProperty(temporalParams[j]));
+            if(dataset.hasTag(row, tag))
+                sourceRows[(size_t)nextRow[(size_t)tag]++] = row;
         }
-        temporalData.data.push_back(childData);
-
-        vec_t encodedLabel = {0, 0, 1, 0, 0, 0, 0, 0, 0};
-        temporalData.labels.push_back(encodedLabel);
     }
     
-    juce::ValueTree swellParent = temporalTree.getChildWithName(DataNodes::TagNodes::Temporal::Parents::SwellParent);
-    for(int i = 0 ; i < swellParent.getNumChildren() ; i++)
+    // store columns are gathered straight into the row major block
+    float* data = output.getDataRow(0);
+    for(int j = 0 ; j < numParams ; j++)
     {
-        juce::ValueTree child = swellParent.getChild(i);
-        vec_t childData;
-        for(int j = 1 ; j < temporalParams.size() ; j++)
-        {
-            childData.push_back(child.getProperty(temporalParams[j]));
-        }
-        temporalData.data.push_back(childData);
-
-        vec_t encodedLabel = {0, 1, 0, 0, 0, 0, 0, 0, 0};
-        temporalData.labels.push_back(encodedLabel);
+        const float* column = dataset.getColumn(j);
+        for(int i = 0 ; i < numRows ; i++)
+            data[(size_t)i * (size_t)numParams + (size_t)j] = column[sourceRows[(size_t)i]];
     }
     
-    juce::ValueTree shortParent = temporalTree.getChildWithName(DataNodes::TagNodes::Temporal::Parents::ShortParent);
-    for(int i = 0 ; i < shortParent.getNumChildren() ; i++)
+    for(int tag = 0 ; tag < numTags ; tag++)
     {
-        juce::ValueTree child = shortParent.getChild(i);
-        vec_t childData;
-        for(int j = 1 ; j < temporalParams.size() ; j++)
-        {
-            childData.push_back(child.getProperty(temporalParams[j]));
-        }
-        temporalData.data.push_back(childData);
-
-        vec_t encodedLabel = {1, 0, 0, 0, 0, 0, 0, 0, 0};
-        temporalData.labels.push_back(encodedLabel);
+        for(int i = tagOffsets[(size_t)tag] ; i < tagOffsets[(size_t)tag + 1] ; i++)
+            output.setTag(i, tag);
     }
 }
 
 void TT_Formatter::scrambleSpectralData()
 {
-    std::vector<size_t> indices(spectralData.data.size());
+    scrambleDataset(spectralData);
+}
+
+void TT_Formatter::scrambleTemporalData()
+{
+    scrambleDataset(temporalData);
+}
+
+void TT_Formatter::scrambleDataset(FormattedData& formatted)
+{
+    std::vector<int> indices ((size_t)formatted.getNumRows());
     std::iota(indices.begin(), indices.end(), 0);
     
     std::random_device rd;
     std::mt19937 g(rd());
     std::shuffle(indices.begin(), indices.end(), g);
     
-    tensor_t shuffledData (indices.size());
-    tensor_t shuffledLabels (indices.size());
+    formatted.permuteRows(indices);
+}
+
+void FormattedData::allocate(int rows, int params, const tensor_t& tagLabels)
+{
+    numRows = rows;
+    numParams = params;
+    numTags = (int)tagLabels.size();
+    numLabels = tagLabels.empty() ? 0 : (int)tagLabels.front().size();
+    
+    values.assign(getLabelOffset() + (size_t)numTags * (size_t)numLabels, 0.0f);
+    rowTags.assign((size_t)rows, 0);
     
-    for (size_t i = 0; i < indices.size(); ++i)
+    float* labels = values.data() + getLabelOffset();
+    for(int tag = 0 ; tag < numTags ; tag++)
     {
-        shuffledData[i] = spectralData.data[indices[i]];
-        shuffledLabels[i] = spectralData.labels[indices[i]];
+        jassert((int)tagLabels[(size_t)tag].size() == numLabels);
+        std::copy(tagLabels[(size_t)tag].begin(), tagLabels[(size_t)tag].end(), labels + (size_t)tag * (size_t)numLabels);
     }
+}
+
+void FormattedData::permuteRows(const std::vector<int>& order)
+{
+    jassert((int)order.size() == numRows);
     
-    spectralData.data = std::move(shuffledData);
-    spectralData.labels = std::move(shuffledLabels);
+    Column permuted (values.size());
+    std::vector<int> permutedTags ((size_t)numRows);
+    
+    for(int i = 0 ; i < numRows ; i++)
+    {
+        Span<const float> row = getData().getRow(order[(size_t)i]);
+        std::copy(row.begin(), row.end(), permuted.data() + (size_t)i * (size_t)numParams);
+        permutedTags[(size_t)i] = rowTags[(size_t)order[(size_t)i]];
+    }
+    
+    std::copy(values.begin() + (std::ptrdiff_t)getLabelOffset(), values.end(), permuted.begin() + (std::ptrdiff_t)getLabelOffset());
+    
+    values = std::move(permuted);
+    rowTags = std::move(permutedTags);
 }
 
-void TT_Formatter::scrambleTemporalData()
+tensor_t FormattedData::toDataTensor() const
 {
-    std::vector<size_t> indices(temporalData.data.size());
-    std::iota(indices.begin(), indices.end(), 0);
+    tensor_t tensor;
+    tensor.reserve((size_t)numRows);
     
-    std::random_device rd;
-    std::mt19937 g(rd());
-    std::shuffle(indices.begin(), indices.end(), g);
+    for(int i = 0 ; i < numRows ; i++)
+    {
+        Span<const float> row = getData().getRow(i);
+        tensor.emplace_back(row.begin(), row.end());
+    }
     
-    tensor_t shuffledData (indices.size());;
-    tensor_t shuffledLabels (indices.size());;
+    return tensor;
+}
+
+tensor_t FormattedData::toLabelTensor() const
+{
+    tensor_t tensor;
+    tensor.reserve((size_t)numRows);
     
-    for (size_t i = 0; i < indices.size(); ++i)
+    for(int i = 0 ; i < numRows ; i++)
     {
-        shuffledData[i] = temporalData.data[indices[i]];
-        shuffledLabels[i] = temporalData.labels[indices[i]];
+        Span<const float> label = getLabel(i);
+        tensor.emplace_back(label.begin(), label.end());
     }
     
-    temporalData.data = std::move(shuffledData);
-    temporalData.labels = std::move(shuffledLabels);
+    return tensor;
 }
@@ -42,6 +42,7 @@
 #pragma once
 #include "../tiny-dnn-master/tiny_dnn/tiny_dnn.h"
 #include "TT_Augmenter.h"
+#include <random>
 
 using namespace tiny_dnn;
 
@@ -51,6 +52,54 @@ struct ParameterData
     tensor_t labels;
 };
 
+/*
+ A formatted dataset held in one 64 byte aligned buffer, every row's parameters, row major,
+ followed by one one-hot label per tag. Rows only keep the index of their tag, a label is
+ never copied per row.
+ 
+ The size is known before anything is written so the buffer is allocated once and filled
+ with a single pass per column. getData() / getTagLabels() / getLabel() are views into it.
+ tiny-dnn's tensor_t owns every row and can't point into the buffer, so toDataTensor() /
+ toLabelTensor() are the only copies, made at the network boundary.
+ */
+
+class FormattedData
+{
+public:
+    
+    // drops the old contents, parameters are zeroed and every tag's label is written once
+    void allocate(int rows, int params, const tensor_t& tagLabels);
+    
+    int getNumRows() const { return numRows; }
+    int getNumParams() const { return numParams; }
+    int getLabelSize() const { return numLabels; }
+    
+    PatchView getData() const { return {values.data(), numRows, numParams}; }
+    PatchView getTagLabels() const { return {values.data() + getLabelOffset(), numTags, numLabels}; }
+    Span<const float> getLabel(int row) const { return getTagLabels().getRow(rowTags[(size_t)row]); }
+    int getTag(int row) const { return rowTags[(size_t)row]; }
+    
+    float* getDataRow(int row) { return values.data() + (size_t)row * (size_t)numParams; }
+    void setTag(int row, int tag) { rowTags[(size_t)row] = tag; }
+    
+    // row i of the result is row order[i] of this, the labels are carried over as they are
+    void permuteRows(const std::vector<int>& order);
+    
+    tensor_t toDataTensor() const;
+    tensor_t toLabelTensor() const;
+    
+private:
+    
+    size_t getLabelOffset() const { return (size_t)numRows * (size_t)numParams; }
+    
+    Column values;
+    std::vector<int> rowTags;
+    int numRows = 0;
+    int numParams = 0;
+    int numTags = 0;
+    int numLabels = 0;
+};
+
 class TT_Formatter
 {
 public:
@@ -64,17 +113,25 @@ public:
     void scrambleSpectralData();
     void scrambleTemporalData();
     
-    ParameterData getSpectralData() { return spectralData; }
-    ParameterData getTemporalData() { return temporalData; }
+    // one-hot label of every tag, indexed like the Spectral / Temporal patchTags arrays
+    static const tensor_t& getSpectralLabels();
+    static const tensor_t& getTemporalLabels();
+    
+    // views into the formatted buffers, grouped by tag until scrambled
+    const FormattedData& getFormattedSpectralData() const { return spectralData; }
+    const FormattedData& getFormattedTemporalData() const { return temporalData; }
+    
+    // tensor copies of the views for tiny-dnn
+    ParameterData getSpectralData() const { return {spectralData.toDataTensor(), spectralData.toLabelTensor()}; }
+    ParameterData getTemporalData() const { return {temporalData.toDataTensor(), temporalData.toLabelTensor()}; }
     
 private:
     
-    std::shared_ptr<juce::ValueTree> dataTree;
+    void formatDataset(const TT_PatchStore& dataset, const tensor_t& tagLabels, FormattedData& output);
+    void scrambleDataset(FormattedData& formatted);
     
-    juce::ValueTree spectralTree;
-    juce::ValueTree temporalTree;
     TT_Augmenter* augmenter;
     
-    ParameterData spectralData;
-    ParameterData temporalData;
+    FormattedData spectralData;
+    FormattedData temporalData;
 };
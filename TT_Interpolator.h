@@ -0,0 +1,101 @@
+/*
+  ==============================================================================
+
+    TT_Interpolator.h
+    Created: 21 Oct 2026 4:52:30pm
+    Author:  Matt Twitchen
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include <algorithm>
+#include <array>
+#include <vector>
+#include "../TT_DataNodes.h"
+#include "TT_Lerp.h"
+#include "TT_Spline.h"
+
+/*
+ Expands a tag by interpolating between each patch and the next one down in magnitude.
+
+ N is the number of parameters interpolated, the first N columns of every row. Every
+ segment and parameter is expanded in one pass, scaleFactor rows strictly between each
+ pair of neighbouring patches, clamped to the range of the originals. A tag with a
+ single patch has nothing to interpolate and gives no rows.
+ 
+ LINEAR runs the kernel in TT_Lerp.h, the cubic kinds run the fitting and evaluation
+ kernel in TT_Spline.h. Timing against the old mlinterp path lives in
+ TT_InterpolatorBenchmark.cpp.
+ */
+
+template <int N>
+class TT_Interpolator
+{
+public:
+    
+    typedef std::array<float, N> Row;
+    
+    TT_Interpolator(InterpolationKind interpolationKind = LINEAR) : kind(interpolationKind) {}
+    
+    static constexpr int getNumParams() { return N; }
+    
+    void setKind(InterpolationKind newKind) { kind = newKind; }
+    InterpolationKind getKind() const { return kind; }
+    
+    // top level function called in TT_Augmenter, tag is sorted by descending magnitude and only needs to live for the call
+    PatchMatrix interpolateTag(PatchView tag, int sf)
+    {
+        jassert(tag.getNumParams() >= N);
+        
+        scaleFactor = juce::jmax(1, sf);
+        numPatches = tag.getNumRows();
+        
+        findRanges(tag);
+        
+        PatchMatrix expandedTag (Lerp::getNumRows(numPatches, scaleFactor), N);
+        
+        if(kind == LINEAR)
+        {
+            Lerp::expandTag<N>(tag, scaleFactor, minimums.data(), maximums.data(), expandedTag);
+        } else
+        {
+            Spline::expandTag<N>(tag, kind, scaleFactor, minimums.data(), maximums.data(), expandedTag);
+        }
+        
+        return expandedTag;
+    }
+    
+private:
+    
+    void findRanges(PatchView tag)
+    {
+        for(int param = 0 ; param < N ; param++)
+        {
+            minimums[(size_t)param] = numPatches > 0 ? tag.get(0, param) : 0.f;
+            maximums[(size_t)param] = minimums[(size_t)param];
+        }
+        
+        for(int i = 0 ; i < numPatches ; i++)
+        {
+            Span<const float> patch = tag.getRow(i);
+            for(int param = 0 ; param < N ; param++)
+            {
+                minimums[(size_t)param] = juce::jmin(minimums[(size_t)param], patch[(size_t)param]);
+                maximums[(size_t)param] = juce::jmax(maximums[(size_t)param], patch[(size_t)param]);
+            }
+        }
+    }
+    
+    InterpolationKind kind;
+    
+    int numPatches = 0;
+    int scaleFactor = 4;
+    
+    Row minimums {};
+    Row maximums {};
+};
+
+typedef TT_Interpolator<DataNodes::ParameterNodes::numInterpolatedSpectralParams> TT_SpectralInterpolator;
+typedef TT_Interpolator<DataNodes::ParameterNodes::numTemporalFeatures> TT_TemporalInterpolator;
@@ -0,0 +1,128 @@
+/*
+  ==============================================================================
+
+    TT_InterpolatorBenchmark.cpp
+    Created: 22 Oct 2026 4:26:11pm
+    Author:  Matt Twitchen
+
+  ==============================================================================
+*/
+
+#include "TT_InterpolatorBenchmark.h"
+#include "TT_Magnitude.h"
+#include "../../mlinterp/mlinterp/mlinterp.hpp"
+
+template <int N>
+PatchMatrix InterpolatorBenchmark::interpolateTagReference(PatchView tag, Span<const float> mags, int scaleFactor)
+{
+    using namespace mlinterp;
+    
+    scaleFactor = juce::jmax(1, scaleFactor);
+    const int numPatches = tag.getNumRows();
+    
+    float minimums[N];
+    float maximums[N];
+    for(int param = 0 ; param < N ; param++)
+    {
+        minimums[param] = numPatches > 0 ? tag.get(0, param) : 0.f;
+        maximums[param] = minimums[param];
+        for(int i = 0 ; i < numPatches ; i++)
+        {
+            minimums[param] = juce::jmin(minimums[param], tag.get(i, param));
+            maximums[param] = juce::jmax(maximums[param], tag.get(i, param));
+        }
+    }
+    
+    PatchMatrix expandedTag (Lerp::getNumRows(numPatches, scaleFactor), N);
+    std::vector<float> xi ((size_t)scaleFactor);
+    std::vector<float> yi ((size_t)scaleFactor);
+    
+    for(int param = 0 ; param < N ; param++)
+    {
+        for(int i = 0 ; i < numPatches - 1 ; i++)
+        {
+            constexpr int nd[] = { 2 };
+            const int ni = scaleFactor;
+            
+            float xd[2] = {mags[(size_t)i], mags[(size_t)(i + 1)]};
+            float yd[2] = {tag.get(i, param), tag.get(i + 1, param)};
+            
+            for(int j = 0 ; j < scaleFactor ; j++)
+                xi[(size_t)j] = xd[0] + (xd[1] - xd[0]) / (scaleFactor + 1) * (j + 1);
+            
+            interp
+            (
+                nd, ni,           // Number of points
+                yd, yi.data(),    // Output axis (y)
+                xd, xi.data()     // Input axis (x)
+            );
+            
+            for(int j = 0 ; j < scaleFactor ; j++)
+                expandedTag.set(i * scaleFactor + j, param, juce::jlimit(minimums[param], maximums[param], yi[(size_t)j]));
+        }
+    }
+    
+    return expandedTag;
+}
+
+template <int N>
+InterpolatorBenchmark::Result InterpolatorBenchmark::run(int numPatches, int scaleFactor, int numRuns)
+{
+    numRuns = juce::jmax(1, numRuns);
+    
+    juce::Random random (0x4c45);
+    PatchMatrix tag (numPatches, N);
+    for(int i = 0 ; i < numPatches ; i++)
+    {
+        for(int param = 0 ; param < N ; param++)
+            tag.set(i, param, random.nextFloat());
+    }
+    
+    std::vector<float> mags ((size_t)numPatches);
+    Magnitude::ofRows(tag, mags.data());
+    Magnitude::sortDescending(tag, mags);
+    
+    TT_Interpolator<N> interpolator;
+    PatchMatrix reference;
+    PatchMatrix expanded;
+    Result result;
+    
+    for(int run = 0 ; run < numRuns ; run++)
+    {
+        const juce::int64 referenceStart = juce::Time::getHighResolutionTicks();
+        reference = interpolateTagReference<N>(tag, mags, scaleFactor);
+        const juce::int64 kernelStart = juce::Time::getHighResolutionTicks();
+        expanded = interpolator.interpolateTag(tag, scaleFactor);
+        const juce::int64 kernelEnd = juce::Time::getHighResolutionTicks();
+        
+        result.referenceSeconds += juce::Time::highResolutionTicksToSeconds(kernelStart - referenceStart);
+        result.kernelSeconds += juce::Time::highResolutionTicksToSeconds(kernelEnd - kernelStart);
+        
+        for(int spline = 0 ; spline < 3 ; spline++)
+        {
+            TT_Interpolator<N> cubic ((InterpolationKind)(PCHIP + spline));
+            const juce::int64 splineStart = juce::Time::getHighResolutionTicks();
+            cubic.interpolateTag(tag, scaleFactor);
+            result.splineSeconds[spline] += juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - splineStart);
+        }
+    }
+    
+    for(int i = 0 ; i < expanded.getNumRows() ; i++)
+    {
+        for(int param = 0 ; param < N ; param++)
+            result.maxDifference = juce::jmax(result.maxDifference, std::abs(expanded.get(i, param) - reference.get(i, param)));
+    }
+    
+    DBG("Interpolation, " << numPatches << " patches x " << scaleFactor << ": reference " << result.referenceSeconds * 1000.0 / numRuns
+        << " ms, kernel " << result.kernelSeconds * 1000.0 / numRuns << " ms, max difference " << result.maxDifference
+        << ", PCHIP " << result.splineSeconds[0] * 1000.0 / numRuns << " ms, Catmull-Rom " << result.splineSeconds[1] * 1000.0 / numRuns
+        << " ms, Akima " << result.splineSeconds[2] * 1000.0 / numRuns << " ms");
+    
+    return result;
+}
+
+template PatchMatrix InterpolatorBenchmark::interpolateTagReference<TT_SpectralInterpolator::getNumParams()>(PatchView, Span<const float>, int);
+template PatchMatrix InterpolatorBenchmark::interpolateTagReference<TT_TemporalInterpolator::getNumParams()>(PatchView, Span<const float>, int);
+
+template InterpolatorBenchmark::Result InterpolatorBenchmark::run<TT_SpectralInterpolator::getNumParams()>(int, int, int);
+template InterpolatorBenchmark::Result InterpolatorBenchmark::run<TT_TemporalInterpolator::getNumParams()>(int, int, int);
@@ -0,0 +1,39 @@
+/*
+  ==============================================================================
+
+    TT_InterpolatorBenchmark.h
+    Created: 22 Oct 2026 4:26:11pm
+    Author:  Matt Twitchen
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "TT_Interpolator.h"
+
+/*
+ Times the interpolation kernels against the per segment, per parameter mlinterp path
+ they replaced, on a random tag sorted by magnitude. Not used by the augmenter, it's the
+ only code that still needs mlinterp, so it's kept out of TT_Interpolator.h.
+ 
+ Instantiated for the spectral and temporal interpolator widths.
+ */
+
+namespace InterpolatorBenchmark
+{
+    struct Result
+    {
+        double referenceSeconds = 0;
+        double kernelSeconds = 0;
+        double splineSeconds[3] = {}; // PCHIP, CATMULL_ROM, AKIMA, coefficients included
+        float maxDifference = 0; // linear kernel vs mlinterp
+    };
+    
+    // numRuns below 1 runs once
+    template <int N>
+    Result run(int numPatches, int scaleFactor, int numRuns);
+    
+    // the old mlinterp path, clamped to the range of the originals like the kernels
+    template <int N>
+    PatchMatrix interpolateTagReference(PatchView tag, Span<const float> mags, int scaleFactor);
+}
@@ -0,0 +1,172 @@
+/*
+  ==============================================================================
+
+    TT_KdTree.cpp
+    Created: 20 Oct 2026 4:16:58pm
+    Author:  Matt Twitchen
+
+  ==============================================================================
+*/
+
+#include "TT_KdTree.h"
+#include <numeric>
+
+TT_KdTree::TT_KdTree(PatchView input) : points(input.getNumParams())
+{
+    const int numPoints = input.getNumRows();
+    
+    originalIndexes.resize((size_t)numPoints);
+    std::iota(originalIndexes.begin(), originalIndexes.end(), 0);
+    nodes.reserve((size_t)(2 * numPoints / leafSize + 1));
+    
+    if(numPoints > 0)
+        build(input, 0, numPoints);
+    
+    // copied in tree order so every leaf is a contiguous block of rows
+    points.reserve(numPoints);
+    treeOrder.resize((size_t)numPoints);
+    for(int i = 0 ; i < numPoints ; i++)
+    {
+        points.addRow(input.getRow(originalIndexes[(size_t)i]).data());
+        treeOrder[(size_t)originalIndexes[(size_t)i]] = i;
+    }
+}
+
+int TT_KdTree::build(PatchView input, int first, int last)
+{
+    const int index = (int)nodes.size();
+    nodes.push_back({first, last});
+    
+    if(last - first <= leafSize)
+        return index;
+    
+    // split on the dimension the points are most spread along
+    int splitDimension = 0;
+    float widestSpread = -1;
+    for(int k = 0 ; k < input.getNumParams() ; k++)
+    {
+        float low = input.get(originalIndexes[(size_t)first], k);
+        float high = low;
+        for(int i = first + 1 ; i < last ; i++)
+        {
+            const float value = input.get(originalIndexes[(size_t)i], k);
+            low = juce::jmin(low, value);
+            high = juce::jmax(high, value);
+        }
+        
+        if(high - low > widestSpread)
+        {
+            widestSpread = high - low;
+            splitDimension = k;
+        }
+    }
+    
+    const int middle = first + (last - first) / 2;
+    std::nth_element(originalIndexes.begin() + first, originalIndexes.begin() + middle, originalIndexes.begin() + last, [&] (int a, int b)
+    {
+        return input.get(a, splitDimension) < input.get(b, splitDimension);
+    });
+    
+    const float splitValue = input.get(originalIndexes[(size_t)middle], splitDimension);
+    const int left = build(input, first, middle);
+    const int right = build(input, middle, last);
+    
+    // nodes may have moved while the children were built
+    Node& node = nodes[(size_t)index];
+    node.splitDimension = splitDimension;
+    node.splitValue = splitValue;
+    node.children[0] = left;
+    node.children[1] = right;
+    
+    return index;
+}
+
+float TT_KdTree::distanceSqr(const float* query, int point) const
+{
+    Span<const float> row = points.getRow(point);
+    float sum = 0;
+    for(size_t k = 0 ; k < row.size() ; k++)
+    {
+        const float difference = row[k] - query[k];
+        sum += difference * difference;
+    }
+    return sum;
+}
+
+void TT_KdTree::search(int index, const float* query, int k, int excludePoint, std::vector<Candidate>& heap) const
+{
+    const Node& node = nodes[(size_t)index];
+    
+    if(node.splitDimension < 0)
+    {
+        for(int point = node.first ; point < node.last ; point++)
+        {
+            if(point == excludePoint)
+                continue;
+            
+            const float distance = distanceSqr(query, point);
+            if((int)heap.size() < k)
+            {
+                heap.push_back({distance, point});
+                std::push_heap(heap.begin(), heap.end());
+            } else if(distance < heap.front().distanceSqr)
+            {
+                std::pop_heap(heap.begin(), heap.end());
+                heap.back() = {distance, point};
+                std::push_heap(heap.begin(), heap.end());
+            }
+        }
+        return;
+    }
+    
+    // nearer side first, the far side only if the splitting plane is closer than the current kth neighbour
+    const float offset = query[node.splitDimension] - node.splitValue;
+    const int nearChild = offset < 0 ? 0 : 1;
+    
+    search(node.children[nearChild], query, k, excludePoint, heap);
+    
+    if((int)heap.size() < k || offset * offset < heap.front().distanceSqr)
+        search(node.children[1 - nearChild], query, k, excludePoint, heap);
+}
+
+int TT_KdTree::findNeighbours(Span<const float> query, int k, int* result, int excludeIndex) const
+{
+    if(nodes.empty() || k <= 0)
+        return 0;
+    
+    jassert((int)query.size() == points.getNumParams());
+    
+    std::vector<Candidate> heap;
+    heap.reserve((size_t)k);
+    
+    const int excludePoint = excludeIndex >= 0 ? treeOrder[(size_t)excludeIndex] : -1;
+    search(0, query.data(), k, excludePoint, heap);
+    
+    std::sort_heap(heap.begin(), heap.end());
+    for(size_t i = 0 ; i < heap.size() ; i++)
+        result[i] = originalIndexes[(size_t)heap[i].point];
+    
+    return (int)heap.size();
+}
+
+std::vector<int> TT_KdTree::findNeighboursOfPoints(int k, int numThreads) const
+{
+    const int numPoints = getNumPoints();
+    std::vector<int> neighbours ((size_t)numPoints * (size_t)k, -1);
+    
+    // neighbouring queries touch the same leaves, so each task takes a run of points in tree order
+    const int numTasks = (numPoints + pointsPerTask - 1) / pointsPerTask;
+    Parallel::forEachTask(numTasks, numThreads, [&] (int task)
+    {
+        const int first = task * pointsPerTask;
+        const int last = juce::jmin(numPoints, first + pointsPerTask);
+        
+        for(int point = first ; point < last ; point++)
+        {
+            const int index = originalIndexes[(size_t)point];
+            findNeighbours(points.getRow(point), k, neighbours.data() + (size_t)index * (size_t)k, index);
+        }
+    });
+    
+    return neighbours;
+}
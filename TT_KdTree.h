@@ -0,0 +1,70 @@
+/*
+  ==============================================================================
+
+    TT_KdTree.h
+    Created: 20 Oct 2026 4:16:58pm
+    Author:  Matt Twitchen
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "TT_Parallel.h"
+#include "TT_PatchMatrix.h"
+
+/*
+ k-d tree over the patches of one tag, used to find true nearest neighbours in
+ parameter space for SMOTE style augmentation.
+ 
+ Built in O(n log n) by splitting on the widest dimension at the median, points are
+ stored in tree order so leaves are contiguous. Queries return indexes into the
+ matrix the tree was built from.
+ */
+
+class TT_KdTree
+{
+public:
+    
+    TT_KdTree(PatchView points);
+    
+    int getNumPoints() const { return points.getNumRows(); }
+    
+    // indexes of the k nearest points to query, closest first, excludeIndex is skipped
+    // returns how many were found, at most k
+    int findNeighbours(Span<const float> query, int k, int* result, int excludeIndex = -1) const;
+    
+    // k nearest other points of every point, numPoints x k row major, -1 where a tag has fewer than k + 1 points
+    // queries are run in tree order across numThreads workers
+    std::vector<int> findNeighboursOfPoints(int k, int numThreads) const;
+    
+private:
+    
+    struct Node
+    {
+        int first; // range in tree order
+        int last;
+        int splitDimension = -1; // -1 for leaves
+        float splitValue = 0;
+        int children[2] = {-1, -1};
+    };
+    
+    struct Candidate
+    {
+        float distanceSqr;
+        int point; // tree order
+        
+        bool operator<(const Candidate& other) const { return distanceSqr < other.distanceSqr; }
+    };
+    
+    int build(PatchView input, int first, int last);
+    void search(int node, const float* query, int k, int excludePoint, std::vector<Candidate>& heap) const;
+    float distanceSqr(const float* query, int point) const;
+    
+    PatchMatrix points; // tree order
+    std::vector<int> originalIndexes;
+    std::vector<int> treeOrder; // original index -> tree order
+    std::vector<Node> nodes;
+    
+    static constexpr int leafSize = 8;
+    static constexpr int pointsPerTask = 256;
+};
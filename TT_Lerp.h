@@ -0,0 +1,86 @@
+/*
+  ==============================================================================
+
+    TT_Lerp.h
+    Created: 22 Oct 2026 9:37:14am
+    Author:  Matt Twitchen
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "TT_PatchMatrix.h"
+#include <algorithm>
+#include <vector>
+
+/*
+ Batch linear interpolation between consecutive patches of a tag.
+
+ Every segment between patch i and patch i + 1 gets scaleFactor rows at
+ t = (j + 1) / (scaleFactor + 1), strictly between the two patches, so no generated row
+ is a copy of an original. All segments and all N parameters are produced in one pass,
+ straight into the output rows and clamped to [minimums, maximums] on the way out.
+
+ N is a compile time constant so the parameter loop is fully unrolled, with no branches
+ in it the compiler emits packed AVX2 / NEON adds, multiplies and min / max for it and
+ falls back to scalar code on anything else.
+ */
+
+namespace Lerp
+{
+    // interior steps of a segment, the patches at either end are never reproduced
+    static inline std::vector<float> getSteps(int scaleFactor)
+    {
+        std::vector<float> steps ((size_t)scaleFactor);
+        for(int j = 0 ; j < scaleFactor ; j++)
+            steps[(size_t)j] = (float)(j + 1) / (scaleFactor + 1);
+        
+        return steps;
+    }
+    
+    // rows generated from a tag of numPatches patches
+    static inline int getNumRows(int numPatches, int scaleFactor)
+    {
+        return juce::jmax(0, numPatches - 1) * scaleFactor;
+    }
+    
+    // output must be getNumRows(numPatches, scaleFactor) rows of exactly N parameters, tag rows may be wider, only the first N are read
+    template <int N>
+    static inline void expandTag(PatchView tag, int scaleFactor, const float* minimums, const float* maximums, PatchMatrix& output)
+    {
+        const int numSegments = juce::jmax(0, tag.getNumRows() - 1);
+        jassert(scaleFactor >= 1);
+        jassert(output.getNumParams() == N && output.getNumRows() == numSegments * scaleFactor);
+        
+        const std::vector<float> steps = getSteps(scaleFactor);
+        
+        float low[N];
+        float high[N];
+        std::copy(minimums, minimums + N, low);
+        std::copy(maximums, maximums + N, high);
+        
+        for(int i = 0 ; i < numSegments ; i++)
+        {
+            const float* from = tag.getRow(i).data();
+            const float* to = tag.getRow(i + 1).data();
+            
+            // locals so the compiler knows the output can't alias them
+            float start[N];
+            float delta[N];
+            for(int p = 0 ; p < N ; p++)
+            {
+                start[p] = from[p];
+                delta[p] = to[p] - from[p];
+            }
+            
+            // a segment's rows are contiguous in the output
+            float* out = output.getRow(i * scaleFactor).data();
+            for(int j = 0 ; j < scaleFactor ; j++, out += N)
+            {
+                const float t = steps[(size_t)j];
+                for(int p = 0 ; p < N ; p++)
+                    out[p] = std::min(high[p], std::max(low[p], start[p] + t * delta[p]));
+            }
+        }
+    }
+}
@@ -0,0 +1,119 @@
+/*
+  ==============================================================================
+
+    TT_MacroRouting.cpp
+    Created: 18 Oct 2026 10:06:22am
+    Author:  Matt Twitchen
+
+  ==============================================================================
+*/
+
+#include "TT_MacroRouting.h"
+
+#define spectralSchema DataNodes::ParameterNodes::spectralSchema
+#define temporalSchema DataNodes::ParameterNodes::temporalSchema
+
+namespace
+{
+    struct ParameterEntry
+    {
+        std::string_view name; // points into the schema
+        int spectral = -1;
+        int temporal = -1;
+    };
+    
+    const std::vector<ParameterEntry>& getParameterTable()
+    {
+        static const std::vector<ParameterEntry> table = []
+        {
+            std::vector<ParameterEntry> entries;
+            auto entryFor = [&entries] (const char* name) -> ParameterEntry&
+            {
+                for(auto& entry : entries)
+                {
+                    if(entry.name == name)
+                        return entry;
+                }
+                entries.push_back({name});
+                return entries.back();
+            };
+            
+            for(auto& param : spectralSchema)
+                entryFor(param.name).spectral = param.column;
+            
+            for(auto& param : temporalSchema)
+                entryFor(param.name).temporal = param.column;
+            
+            jassert((int)entries.size() <= ParameterIDs::maxIDs);
+            return entries;
+        }();
+        
+        return table;
+    }
+}
+
+int ParameterIDs::intern(std::string_view name)
+{
+    const auto& table = getParameterTable();
+    for(size_t i = 0 ; i < table.size() ; i++)
+    {
+        if(table[i].name == name)
+            return (int)i;
+    }
+    return -1;
+}
+
+int ParameterIDs::getNumIDs()
+{
+    return (int)getParameterTable().size();
+}
+
+int ParameterIDs::getSpectralIndex(int id)
+{
+    return getParameterTable()[(size_t)id].spectral;
+}
+
+int ParameterIDs::getTemporalIndex(int id)
+{
+    return getParameterTable()[(size_t)id].temporal;
+}
+
+void TT_MacroRouting::addRoute(int parameterID, float amount)
+{
+    if(parameterID < 0)
+        return;
+    
+    jassert(numMacros > 0);
+    routes.push_back({numMacros - 1, parameterID, amount});
+}
+
+void TT_MacroRouting::apply(ParsedPatch& patch) const
+{
+    if(routes.empty())
+        return;
+    
+    std::array<float, ParameterIDs::maxIDs> offsets {};
+    for(auto& route : routes)
+        offsets[(size_t)route.parameterID] += route.amount;
+    
+    for(int id = 0 ; id < ParameterIDs::getNumIDs() ; id++)
+    {
+        if(offsets[(size_t)id] == 0.f)
+            continue;
+        
+        // macros can't push a parameter out of its range
+        const int spectral = ParameterIDs::getSpectralIndex(id);
+        if(spectral >= 0)
+        {
+            const auto& param = spectralSchema[spectral];
+            patch.spectralValues[(size_t)spectral] = juce::jlimit(param.minimum, param.maximum, patch.spectralValues[(size_t)spectral] + offsets[(size_t)id]);
+        }
+        
+        const int temporal = ParameterIDs::getTemporalIndex(id);
+        if(temporal >= 0)
+        {
+            const auto& param = temporalSchema[temporal];
+            patch.temporalValues[(size_t)temporal] = juce::jlimit(param.minimum, param.maximum, patch.temporalValues[(size_t)temporal] + offsets[(size_t)id]);
+        }
+    }
+}
@@ -0,0 +1,66 @@
+/*
+  ==============================================================================
+
+    TT_MacroRouting.h
+    Created: 18 Oct 2026 10:06:22am
+    Author:  Matt Twitchen
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "TT_ParsedPatch.h"
+#include <string_view>
+
+// interned ids for every parameter the fetcher keeps, FilterContour is a single id shared by both types
+namespace ParameterIDs
+{
+    static constexpr int maxIDs = DataNodes::ParameterNodes::numSpectralParams + DataNodes::ParameterNodes::numTemporalParams;
+    
+    int intern(std::string_view name); // -1 if it isn't a parameter we keep
+    int getNumIDs();
+    int getSpectralIndex(int id); // -1 if the parameter isn't spectral
+    int getTemporalIndex(int id); // -1 if the parameter isn't temporal
+}
+
+/*
+ Sparse macro -> parameter routing for one patch.
+ 
+ Built once while reading macro_data, each route is (macro, parameter id, amount).
+ apply() folds every route into a per parameter offset and then walks the spectral
+ and temporal columns once, so the cost is linear in routes + parameters.
+ 
+ Offsets from every macro targeting a parameter are summed before clamping to the
+ [0, 1] parameter range. A route can carry its own amount, otherwise it takes the
+ amount of the macro it belongs to.
+ */
+
+class TT_MacroRouting
+{
+public:
+    
+    void clear() { routes.clear(); numMacros = 0; macroAmount = 0.f; }
+    
+    // starts the next macro, routes added after this belong to it
+    void beginMacro(float amount) { numMacros++; macroAmount = amount; }
+    void addRoute(int parameterID) { addRoute(parameterID, macroAmount); }
+    void addRoute(int parameterID, float amount);
+    
+    int getNumMacros() const { return numMacros; }
+    int getNumRoutes() const { return (int)routes.size(); }
+    
+    void apply(ParsedPatch& patch) const;
+    
+private:
+    
+    struct Route
+    {
+        int macro;
+        int parameterID;
+        float amount;
+    };
+    
+    std::vector<Route> routes;
+    int numMacros = 0;
+    float macroAmount = 0.f;
+};
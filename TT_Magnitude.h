@@ -0,0 +1,154 @@
+/*
+  ==============================================================================
+
+    TT_Magnitude.h
+    Created: 19 Oct 2026 5:08:37pm
+    Author:  Matt Twitchen
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "TT_PatchMatrix.h"
+#include <cmath>
+#include <cstring>
+#include <numeric>
+
+/*
+ Patch magnitudes and magnitude ordering for the augmenter.
+ 
+ A patch's magnitude is the euclidean norm of all but its last two parameters, that's
+ what the interpolators use as their x axis. Magnitudes are computed once per tag in a
+ batch and then used as precomputed sort keys, patches and magnitudes are reordered
+ together so they never drift apart.
+ */
+
+namespace Magnitude
+{
+    // parameters that count towards a patch's magnitude
+    static inline int getNumMagnitudeParams(int numParams)
+    {
+        return juce::jmax(0, numParams - 2);
+    }
+    
+    static inline float ofPatch(Span<const float> patch)
+    {
+        float magnitudeSqr = 0.f;
+        for(int i = 0 ; i < getNumMagnitudeParams((int)patch.size()) ; i++)
+            magnitudeSqr += patch[(size_t)i] * patch[(size_t)i];
+        
+        return std::sqrt(magnitudeSqr);
+    }
+    
+    // column major input, column k of numRows values starts at columns + k * numRows
+    // every loop runs down contiguous columns so the whole batch vectorises
+    static inline void ofColumns(const float* columns, int numRows, int numColumns, float* magnitudes)
+    {
+        std::fill(magnitudes, magnitudes + numRows, 0.0f);
+        
+        for(int k = 0 ; k < getNumMagnitudeParams(numColumns) ; k++)
+        {
+            const float* column = columns + (size_t)k * (size_t)numRows;
+            for(int i = 0 ; i < numRows ; i++)
+                magnitudes[i] += column[i] * column[i];
+        }
+        
+        for(int i = 0 ; i < numRows ; i++)
+            magnitudes[i] = std::sqrt(magnitudes[i]);
+    }
+    
+    static inline void ofRows(PatchView patches, float* magnitudes)
+    {
+        for(int i = 0 ; i < patches.getNumRows() ; i++)
+            magnitudes[i] = ofPatch(patches.getRow(i));
+    }
+    
+    // tags at least this big are radix sorted
+    static constexpr int radixSortThreshold = 256;
+    
+    // maps a float onto a uint32 whose unsigned order is the reverse of the float order
+    static inline juce::uint32 toDescendingKey(float value)
+    {
+        juce::uint32 bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        bits = (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+        return ~bits;
+    }
+    
+    // stable order of indexes by descending key, keys are left untouched
+    static inline std::vector<int> sortDescending(const float* keys, int numKeys)
+    {
+        std::vector<int> order ((size_t)numKeys);
+        std::iota(order.begin(), order.end(), 0);
+        
+        if(numKeys < radixSortThreshold)
+        {
+            std::stable_sort(order.begin(), order.end(), [keys] (int a, int b) { return keys[a] > keys[b]; });
+            return order;
+        }
+        
+        // least significant digit first, four 8 bit passes
+        std::vector<juce::uint32> radixKeys ((size_t)numKeys);
+        for(int i = 0 ; i < numKeys ; i++)
+            radixKeys[(size_t)i] = toDescendingKey(keys[i]);
+        
+        std::vector<int> scratch ((size_t)numKeys);
+        for(int shift = 0 ; shift < 32 ; shift += 8)
+        {
+            int counts[257] = {};
+            for(int index : order)
+                counts[((radixKeys[(size_t)index] >> shift) & 0xff) + 1]++;
+            
+            for(int digit = 0 ; digit < 256 ; digit++)
+                counts[digit + 1] += counts[digit];
+            
+            for(int index : order)
+                scratch[(size_t)counts[(radixKeys[(size_t)index] >> shift) & 0xff]++] = index;
+            
+            order.swap(scratch);
+        }
+        
+        return order;
+    }
+    
+    // moves row order[i] to row i of both patches and magnitudes, following permutation cycles in place
+    static inline void applyOrder(const std::vector<int>& order, PatchMatrix& patches, std::vector<float>& magnitudes)
+    {
+        const int numRows = (int)order.size();
+        jassert(patches.getNumRows() == numRows && (int)magnitudes.size() == numRows);
+        
+        std::vector<float> heldRow ((size_t)patches.getNumParams());
+        std::vector<bool> placed ((size_t)numRows, false);
+        
+        for(int start = 0 ; start < numRows ; start++)
+        {
+            if(placed[(size_t)start] || order[(size_t)start] == start)
+                continue;
+            
+            Span<float> startRow = patches.getRow(start);
+            std::copy(startRow.begin(), startRow.end(), heldRow.begin());
+            const float heldMagnitude = magnitudes[(size_t)start];
+            
+            int row = start;
+            while(order[(size_t)row] != start)
+            {
+                const int source = order[(size_t)row];
+                Span<float> sourceRow = patches.getRow(source);
+                std::copy(sourceRow.begin(), sourceRow.end(), patches.getRow(row).begin());
+                magnitudes[(size_t)row] = magnitudes[(size_t)source];
+                placed[(size_t)row] = true;
+                row = source;
+            }
+            
+            std::copy(heldRow.begin(), heldRow.end(), patches.getRow(row).begin());
+            magnitudes[(size_t)row] = heldMagnitude;
+            placed[(size_t)row] = true;
+        }
+    }
+    
+    // sorts patches by descending magnitude, magnitudes[i] must belong to row i
+    static inline void sortDescending(PatchMatrix& patches, std::vector<float>& magnitudes)
+    {
+        applyOrder(sortDescending(magnitudes.data(), (int)magnitudes.size()), patches, magnitudes);
+    }
+}
@@ -0,0 +1,95 @@
+/*
+  ==============================================================================
+
+    TT_NoiseEngine.cpp
+    Created: 19 Oct 2026 10:21:46am
+    Author:  Matt Twitchen
+
+  ==============================================================================
+*/
+
+#include "TT_NoiseEngine.h"
+
+TT_NoiseEngine::TT_NoiseEngine(int numParameters, juce::uint32 streamID) : stream(streamID), scales((size_t)numParameters, 1.0f)
+{
+}
+
+void TT_NoiseEngine::setParameterScales(const std::vector<float>& newScales)
+{
+    jassert(newScales.size() == scales.size());
+    std::copy_n(newScales.begin(), juce::jmin(newScales.size(), scales.size()), scales.begin());
+}
+
+void TT_NoiseEngine::addNoise(float* column, int numValues, int param, juce::uint32 sequence) const
+{
+    std::vector<float> noise ((size_t)numValues);
+    fillUniform(noise.data(), numValues, param, sequence);
+    
+    const float width = amount * scales[(size_t)param];
+    for(int i = 0 ; i < numValues ; i++)
+        column[i] = juce::jlimit(0.0f, 1.0f, column[i] + noise[(size_t)i] * width);
+}
+
+void TT_NoiseEngine::fillUniform(float* destination, int numValues, int param, juce::uint32 sequence) const
+{
+    // Philox4x32 constants
+    const juce::uint32 multiplier0 = 0xD2511F53u;
+    const juce::uint32 multiplier1 = 0xCD9E8D57u;
+    const juce::uint32 weyl0 = 0x9E3779B9u;
+    const juce::uint32 weyl1 = 0xBB67AE85u;
+    
+    const juce::uint32 counter1 = (juce::uint32)param;
+    const juce::uint32 counter2 = sequence;
+    const juce::uint32 counter3 = stream;
+    
+    const int numBlocks = (numValues + blockSize - 1) / blockSize;
+    
+    for(int first = 0 ; first < numBlocks ; first += blocksPerBatch)
+    {
+        // one lane per block, every round is the same arithmetic across the lanes
+        juce::uint32 x0[blocksPerBatch], x1[blocksPerBatch], x2[blocksPerBatch], x3[blocksPerBatch];
+        for(int lane = 0 ; lane < blocksPerBatch ; lane++)
+        {
+            x0[lane] = (juce::uint32)(first + lane);
+            x1[lane] = counter1;
+            x2[lane] = counter2;
+            x3[lane] = counter3;
+        }
+        
+        juce::uint32 key0 = (juce::uint32)seed;
+        juce::uint32 key1 = (juce::uint32)(seed >> 32);
+        
+        for(int round = 0 ; round < 10 ; round++)
+        {
+            for(int lane = 0 ; lane < blocksPerBatch ; lane++)
+            {
+                const juce::uint64 product0 = (juce::uint64)multiplier0 * x0[lane];
+                const juce::uint64 product1 = (juce::uint64)multiplier1 * x2[lane];
+                
+                const juce::uint32 y0 = (juce::uint32)(product1 >> 32) ^ x1[lane] ^ key0;
+                const juce::uint32 y1 = (juce::uint32)product1;
+                const juce::uint32 y2 = (juce::uint32)(product0 >> 32) ^ x3[lane] ^ key1;
+                const juce::uint32 y3 = (juce::uint32)product0;
+                
+                x0[lane] = y0;
+                x1[lane] = y1;
+                x2[lane] = y2;
+                x3[lane] = y3;
+            }
+            
+            key0 += weyl0;
+            key1 += weyl1;
+        }
+        
+        // top 24 bits of each word map exactly onto floats in [-1, 1)
+        const float toUnit = 1.0f / 8388608.0f;
+        for(int lane = 0 ; lane < blocksPerBatch ; lane++)
+        {
+            const int index = (first + lane) * blockSize;
+            const juce::uint32 words[blockSize] = {x0[lane], x1[lane], x2[lane], x3[lane]};
+            
+            for(int k = 0 ; k < blockSize && index + k < numValues ; k++)
+                destination[index + k] = (float)(words[k] >> 8) * toUnit - 1.0f;
+        }
+    }
+}
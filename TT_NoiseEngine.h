@@ -0,0 +1,64 @@
+/*
+  ==============================================================================
+
+    TT_NoiseEngine.h
+    Created: 19 Oct 2026 10:21:46am
+    Author:  Matt Twitchen
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include <vector>
+
+/*
+ Counter based uniform noise for augmentation.
+ 
+ Values come from Philox4x32-10 keyed by the seed, the counter is (block, param,
+ sequence, stream). The augmenter uses one sequence per (tag, replica) pair, the batch
+ source one per batch, so every one of them is an independent stream.
+ Nothing is carried between calls, the same seed always gives bit identical rows and
+ replicas can be generated on any thread in any order.
+ 
+ Noise is uniform in +-amount * scale of the parameter and the result is clamped to [0, 1].
+ */
+
+class TT_NoiseEngine
+{
+public:
+    
+    // stream separates engines sharing a seed, e.g. the spectral and temporal datasets
+    TT_NoiseEngine(int numParameters, juce::uint32 streamID);
+    
+    void setSeed(juce::uint64 newSeed) { seed = newSeed; }
+    void setStream(juce::uint32 streamID) { stream = streamID; }
+    void setAmount(float newAmount) { amount = newAmount; }
+    // multiplies amount per parameter, all 1 by default
+    void setParameterScales(const std::vector<float>& newScales);
+    
+    juce::uint64 getSeed() const { return seed; }
+    float getAmount() const { return amount; }
+    int getNumParams() const { return (int)scales.size(); }
+    
+    static juce::uint32 getSequence(int tag, int replica) { return ((juce::uint32)tag << 16) | ((juce::uint32)replica & 0xffff); }
+    
+    // adds noise to a contiguous column of numValues values of one parameter
+    void addNoise(float* column, int numValues, int param, int tag, int replica) const { addNoise(column, numValues, param, getSequence(tag, replica)); }
+    void addNoise(float* column, int numValues, int param, juce::uint32 sequence) const;
+    
+    // fills numValues uniform values in [-1, 1), param only picks the stream so it can go past getNumParams()
+    void fillUniform(float* destination, int numValues, int param, int tag, int replica) const { fillUniform(destination, numValues, param, getSequence(tag, replica)); }
+    void fillUniform(float* destination, int numValues, int param, juce::uint32 sequence) const;
+    
+private:
+    
+    static constexpr int blockSize = 4; // values per Philox call
+    static constexpr int blocksPerBatch = 8; // calls done side by side so the rounds vectorise
+    static constexpr juce::uint64 defaultSeed = 0x54546e6f697365ull;
+    
+    juce::uint32 stream;
+    juce::uint64 seed = defaultSeed;
+    float amount = 0.15f;
+    std::vector<float> scales;
+};
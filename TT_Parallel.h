@@ -0,0 +1,56 @@
+/*
+  ==============================================================================
+
+    TT_Parallel.h
+    Created: 17 Oct 2026 9:12:08am
+    Author:  Matt Twitchen
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include <atomic>
+#include <functional>
+
+namespace Parallel
+{
+    // number of workers to use when a stage isn't given an explicit thread count
+    static inline int defaultNumThreads()
+    {
+        return juce::jmax(1, juce::SystemStats::getNumCpus());
+    }
+
+    // runs task(i) for every i in [0, numTasks) across numThreads workers, blocks until every task has finished
+    static inline void forEachTask(int numTasks, int numThreads, const std::function<void(int)>& task)
+    {
+        if(numTasks <= 0)
+            return;
+        
+        if(numThreads <= 1 || numTasks == 1)
+        {
+            for(int i = 0 ; i < numTasks ; i++)
+                task(i);
+            return;
+        }
+        
+        // declared before the pool so they outlive its worker threads
+        juce::WaitableEvent finished;
+        std::atomic<int> tasksRemaining {numTasks};
+        
+        juce::ThreadPool pool (juce::jmin(numThreads, numTasks));
+        
+        for(int i = 0 ; i < numTasks ; i++)
+        {
+            pool.addJob([&, i]
+            {
+                task(i);
+                
+                if(--tasksRemaining == 0)
+                    finished.signal();
+            });
+        }
+        
+        finished.wait();
+    }
+}
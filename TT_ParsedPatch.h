@@ -0,0 +1,38 @@
+/*
+  ==============================================================================
+
+    TT_ParsedPatch.h
+    Created: 17 Oct 2026 1:48:15pm
+    Author:  Matt Twitchen
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "TT_DataNodes.h"
+#include <array>
+
+// identifies the exact version of a patch file that a ParsedPatch was read from
+struct FileFingerprint
+{
+    juce::String fileName; // relative to the patch library
+    juce::int64 size = 0;
+    juce::int64 modificationTime = 0; // ms since epoch
+    juce::uint64 contentHash = 0;
+};
+
+// everything parseXML pulls out of a single patch file, merged into the parent trees once parsing is done
+struct ParsedPatch
+{
+    juce::String name;
+    FileFingerprint fingerprint;
+    
+    juce::uint32 spectralTagMask = 0; // bit n = Spectral::Patch::patchTags[n]
+    juce::uint32 temporalTagMask = 0; // bit n = Temporal::Patch::patchTags[n]
+    
+    // indexed by ParameterNodes::Spectral/Temporal columns, macros applied, start at the schema defaults
+    std::array<float, DataNodes::ParameterNodes::numSpectralParams> spectralValues = DataNodes::ParameterNodes::getDefaultValues(DataNodes::ParameterNodes::spectralSchema);
+    std::array<float, DataNodes::ParameterNodes::numTemporalParams> temporalValues = DataNodes::ParameterNodes::getDefaultValues(DataNodes::ParameterNodes::temporalSchema);
+    
+    bool isValid = false;
+};
@@ -0,0 +1,247 @@
+/*
+  ==============================================================================
+
+    TT_PatchCache.cpp
+    Created: 17 Oct 2026 1:48:15pm
+    Author:  Matt Twitchen
+
+  ==============================================================================
+*/
+
+#include "TT_PatchCache.h"
+
+#define numSpectral DataNodes::ParameterNodes::numSpectralParams
+#define numTemporal DataNodes::ParameterNodes::numTemporalParams
+
+static const char snapshotMagic[4] = {'T', 'T', 'P', 'C'};
+
+bool TT_PatchCache::load(const juce::File& snapshotFile)
+{
+    release();
+    
+    if(!snapshotFile.existsAsFile())
+        return false;
+    
+    mappedFile = std::make_unique<juce::MemoryMappedFile>(snapshotFile, juce::MemoryMappedFile::readOnly);
+    
+    const char* data = static_cast<const char*>(mappedFile->getData());
+    const size_t size = mappedFile->getSize();
+    
+    if(data == nullptr || size < sizeof(Header))
+    {
+        release();
+        return false;
+    }
+    
+    Header header;
+    std::memcpy(&header, data, sizeof(Header));
+    
+    if(std::memcmp(header.magic, snapshotMagic, sizeof(snapshotMagic)) != 0
+       || header.version != formatVersion
+       || header.numSpectralParams != numSpectral
+       || header.numTemporalParams != numTemporal
+       || size != getSnapshotSize(header.numEntries, header.stringTableSize))
+    {
+        DBG("Patch cache is stale, reparsing library");
+        release();
+        return false;
+    }
+    
+    // sections are laid out so each one is naturally aligned relative to the page aligned mapping
+    numEntries = (int)header.numEntries;
+    const char* section = data + sizeof(Header);
+    records = reinterpret_cast<const Record*>(section);
+    section += sizeof(Record) * numEntries;
+    spectralColumns = reinterpret_cast<const float*>(section);
+    section += sizeof(float) * numSpectral * numEntries;
+    temporalColumns = reinterpret_cast<const float*>(section);
+    section += sizeof(float) * numTemporal * numEntries;
+    tagMasks = reinterpret_cast<const juce::uint32*>(section);
+    section += sizeof(juce::uint32) * numEntries;
+    stringTable = section;
+    stringTableSize = header.stringTableSize;
+    
+    entryIndexes.reserve(numEntries);
+    for(int i = 0 ; i < numEntries ; i++)
+    {
+        const Record& record = records[i];
+        if((size_t)record.fileNameOffset + record.fileNameLength > stringTableSize
+           || (size_t)record.nameOffset + record.nameLength > stringTableSize)
+        {
+            DBG("Patch cache is corrupt, reparsing library");
+            release();
+            return false;
+        }
+        
+        entryIndexes[getString(record.fileNameOffset, record.fileNameLength).toStdString()] = i;
+    }
+    
+    return true;
+}
+
+void TT_PatchCache::release()
+{
+    entryIndexes.clear();
+    numEntries = 0;
+    records = nullptr;
+    spectralColumns = nullptr;
+    temporalColumns = nullptr;
+    tagMasks = nullptr;
+    stringTable = nullptr;
+    stringTableSize = 0;
+    mappedFile.reset();
+}
+
+bool TT_PatchCache::write(const juce::File& snapshotFile, const std::vector<const ParsedPatch*>& patches)
+{
+    std::vector<const ParsedPatch*> toWrite;
+    toWrite.reserve(patches.size());
+    for(auto* patch : patches)
+    {
+        // a patch that failed to read never got a content hash
+        if(patch->isValid || patch->fingerprint.contentHash != 0)
+            toWrite.push_back(patch);
+    }
+    
+    const size_t entries = toWrite.size();
+    
+    std::vector<Record> fingerprints (entries);
+    std::vector<float> spectral (numSpectral * entries);
+    std::vector<float> temporal (numTemporal * entries);
+    std::vector<juce::uint32> masks (entries);
+    juce::MemoryBlock strings;
+    
+    auto addString = [&strings] (const juce::String& toAdd, juce::uint32& offset, juce::uint32& length)
+    {
+        offset = (juce::uint32)strings.getSize();
+        length = (juce::uint32)toAdd.getNumBytesAsUTF8();
+        strings.append(toAdd.toRawUTF8(), length);
+    };
+    
+    for(size_t i = 0 ; i < entries ; i++)
+    {
+        const ParsedPatch& patch = *toWrite[i];
+        Record& record = fingerprints[i];
+        
+        record.size = patch.fingerprint.size;
+        record.modificationTime = patch.fingerprint.modificationTime;
+        record.contentHash = patch.fingerprint.contentHash;
+        addString(patch.fingerprint.fileName, record.fileNameOffset, record.fileNameLength);
+        addString(patch.name, record.nameOffset, record.nameLength);
+        
+        for(int k = 0 ; k < numSpectral ; k++)
+            spectral[k * entries + i] = patch.spectralValues[k];
+        
+        for(int k = 0 ; k < numTemporal ; k++)
+            temporal[k * entries + i] = patch.temporalValues[k];
+        
+        masks[i] = (patch.isValid ? validBit : 0) | patch.spectralTagMask | (patch.temporalTagMask << temporalTagShift);
+    }
+    
+    Header header;
+    std::memcpy(header.magic, snapshotMagic, sizeof(snapshotMagic));
+    header.version = formatVersion;
+    header.numSpectralParams = numSpectral;
+    header.numTemporalParams = numTemporal;
+    header.numEntries = (juce::uint32)entries;
+    header.stringTableSize = (juce::uint32)strings.getSize();
+    
+    if(snapshotFile.getParentDirectory().createDirectory().failed())
+        return false;
+    
+    // write next to the old snapshot and swap it in so a crash never leaves a half written cache
+    juce::File tempFile = snapshotFile.getSiblingFile(snapshotFile.getFileName() + ".tmp");
+    {
+        juce::FileOutputStream stream (tempFile);
+        if(!stream.openedOk())
+            return false;
+        
+        stream.truncate();
+        stream.write(&header, sizeof(Header));
+        stream.write(fingerprints.data(), sizeof(Record) * entries);
+        stream.write(spectral.data(), sizeof(float) * spectral.size());
+        stream.write(temporal.data(), sizeof(float) * temporal.size());
+        stream.write(masks.data(), sizeof(juce::uint32) * entries);
+        stream.write(strings.getData(), strings.getSize());
+        stream.flush();
+        
+        if(stream.getStatus().failed())
+            return false;
+    }
+    
+    jassert(tempFile.getSize() == (juce::int64)getSnapshotSize(entries, strings.getSize()));
+    
+    return tempFile.moveFileTo(snapshotFile);
+}
+
+juce::uint64 TT_PatchCache::hashContent(const void* data, size_t size)
+{
+    const juce::uint8* bytes = static_cast<const juce::uint8*>(data);
+    juce::uint64 hash = 14695981039346656037ull;
+    
+    for(size_t i = 0 ; i < size ; i++)
+    {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    
+    return hash;
+}
+
+int TT_PatchCache::findEntry(const juce::String& fileName) const
+{
+    auto found = entryIndexes.find(fileName.toStdString());
+    return found != entryIndexes.end() ? found->second : -1;
+}
+
+FileFingerprint TT_PatchCache::getFingerprint(int entry) const
+{
+    jassert(juce::isPositiveAndBelow(entry, numEntries));
+    
+    const Record& record = records[entry];
+    
+    FileFingerprint fingerprint;
+    fingerprint.fileName = getString(record.fileNameOffset, record.fileNameLength);
+    fingerprint.size = record.size;
+    fingerprint.modificationTime = record.modificationTime;
+    fingerprint.contentHash = record.contentHash;
+    
+    return fingerprint;
+}
+
+ParsedPatch TT_PatchCache::getPatch(int entry) const
+{
+    jassert(juce::isPositiveAndBelow(entry, numEntries));
+    
+    ParsedPatch patch;
+    patch.fingerprint = getFingerprint(entry);
+    patch.name = getString(records[entry].nameOffset, records[entry].nameLength);
+    
+    for(int k = 0 ; k < numSpectral ; k++)
+        patch.spectralValues[k] = spectralColumns[k * numEntries + entry];
+    
+    for(int k = 0 ; k < numTemporal ; k++)
+        patch.temporalValues[k] = temporalColumns[k * numEntries + entry];
+    
+    const juce::uint32 mask = tagMasks[entry];
+    patch.spectralTagMask = mask & tagFieldMask;
+    patch.temporalTagMask = (mask >> temporalTagShift) & tagFieldMask;
+    
+    patch.isValid = (mask & validBit) != 0;
+    return patch;
+}
+
+size_t TT_PatchCache::getSnapshotSize(size_t entries, size_t stringTableSize)
+{
+    return sizeof(Header)
+         + sizeof(Record) * entries
+         + sizeof(float) * (numSpectral + numTemporal) * entries
+         + sizeof(juce::uint32) * entries
+         + stringTableSize;
+}
+
+juce::String TT_PatchCache::getString(juce::uint32 offset, juce::uint32 length) const
+{
+    jassert((size_t)offset + length <= stringTableSize);
+    return juce::String::fromUTF8(stringTable + offset, (int)length);
+}
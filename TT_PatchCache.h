@@ -0,0 +1,104 @@
+/*
+  ==============================================================================
+
+    TT_PatchCache.h
+    Created: 17 Oct 2026 1:48:15pm
+    Author:  Matt Twitchen
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "TT_ParsedPatch.h"
+#include <unordered_map>
+
+/*
+ BINARY SNAPSHOT LAYOUT:
+ 
+ Native byte order, any change to the layout must bump formatVersion.
+ 
+    Header
+    Fingerprints    - one Record per entry
+    Spectral values - numSpectralParams columns of numEntries floats
+    Temporal values - numTemporalParams columns of numEntries floats
+    Tag masks       - numEntries uint32, bits 0-7 spectral tags, 8-15 temporal tags, 31 valid
+    String table    - file names and patch names, UTF-8, not terminated
+ 
+ Files that were read but didn't parse are kept as entries with the valid bit clear, so
+ a library with a broken patch in it doesn't get reparsed and rewritten on every run.
+ */
+
+class TT_PatchCache
+{
+public:
+    
+    TT_PatchCache() = default;
+    ~TT_PatchCache() = default;
+    
+    // maps an existing snapshot, returns false if there isn't one or it was written by a different format
+    bool load(const juce::File& snapshotFile);
+    // unmaps the snapshot so the file can be replaced
+    void release();
+    
+    // writes every patch that was read to a new snapshot, replacing the old one once it's complete,
+    // unreadable files are left out so they're tried again next time
+    static bool write(const juce::File& snapshotFile, const std::vector<const ParsedPatch*>& patches);
+    
+    // 64 bit FNV-1a, only needs to be stable between runs
+    static juce::uint64 hashContent(const void* data, size_t size);
+    
+    int getNumEntries() const { return numEntries; }
+    // index of the cached entry for a library file, -1 if it isn't in the snapshot
+    int findEntry(const juce::String& fileName) const;
+    
+    FileFingerprint getFingerprint(int entry) const;
+    ParsedPatch getPatch(int entry) const;
+    
+private:
+    
+    // 2: tags matched as whole tokens
+    // 3: first value of a duplicated parameter id wins, entities decoded in patch names
+    // 4: invalid patches cached as negative entries
+    // 5: macro routes carry their own amount, offsets are summed and clamped at both ends
+    // 6: tags split on whitespace as well
+    static constexpr juce::uint32 formatVersion = 6;
+    static constexpr juce::uint32 validBit = 1u << 31;
+    static constexpr int temporalTagShift = 8;
+    static constexpr juce::uint32 tagFieldMask = 0xff;
+    
+    struct Header
+    {
+        char magic[4];
+        juce::uint32 version;
+        juce::uint32 numSpectralParams;
+        juce::uint32 numTemporalParams;
+        juce::uint32 numEntries;
+        juce::uint32 stringTableSize;
+    };
+    
+    struct Record
+    {
+        juce::int64 size;
+        juce::int64 modificationTime;
+        juce::uint64 contentHash;
+        juce::uint32 fileNameOffset;
+        juce::uint32 fileNameLength;
+        juce::uint32 nameOffset;
+        juce::uint32 nameLength;
+    };
+    
+    static size_t getSnapshotSize(size_t entries, size_t stringTableSize);
+    juce::String getString(juce::uint32 offset, juce::uint32 length) const;
+    
+    std::unique_ptr<juce::MemoryMappedFile> mappedFile;
+    
+    int numEntries = 0;
+    const Record* records = nullptr;
+    const float* spectralColumns = nullptr;
+    const float* temporalColumns = nullptr;
+    const juce::uint32* tagMasks = nullptr;
+    const char* stringTable = nullptr;
+    juce::uint32 stringTableSize = 0;
+    
+    std::unordered_map<std::string, int> entryIndexes;
+};
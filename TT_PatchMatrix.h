@@ -0,0 +1,141 @@
+/*
+  ==============================================================================
+
+    TT_PatchMatrix.h
+    Created: 19 Oct 2026 2:40:12pm
+    Author:  Matt Twitchen
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include <atomic>
+#include <vector>
+
+// non owning view of contiguous values, stands in for std::span until the project moves to C++20
+template <typename T>
+class Span
+{
+public:
+    
+    Span() = default;
+    Span(T* d, size_t n) : values(d), numValues(n) {}
+    template <typename Container>
+    Span(Container& c) : values(c.data()), numValues(c.size()) {}
+    template <typename U>
+    Span(const Span<U>& other) : values(other.data()), numValues(other.size()) {}
+    
+    T* data() const { return values; }
+    size_t size() const { return numValues; }
+    bool empty() const { return numValues == 0; }
+    
+    T* begin() const { return values; }
+    T* end() const { return values + numValues; }
+    T& operator[](size_t i) const { return values[i]; }
+    
+    Span subspan(size_t offset, size_t count) const { return {values + offset, count}; }
+    
+private:
+    
+    T* values = nullptr;
+    size_t numValues = 0;
+};
+
+class PatchMatrix;
+
+// non owning view of a row major patch matrix, one row per patch
+class PatchView
+{
+public:
+    
+    PatchView() = default;
+    PatchView(const float* d, int rows, int params) : values(d), numRows(rows), numParams(params) {}
+    
+    int getNumRows() const { return numRows; }
+    int getNumParams() const { return numParams; }
+    bool empty() const { return numRows == 0; }
+    
+    Span<const float> getRow(int row) const { return {values + (size_t)row * (size_t)numParams, (size_t)numParams}; }
+    float get(int row, int param) const { return values[(size_t)row * (size_t)numParams + (size_t)param]; }
+    const float* data() const { return values; }
+    
+private:
+    
+    const float* values = nullptr;
+    int numRows = 0;
+    int numParams = 0;
+};
+
+/*
+ Owning row major patch matrix, the buffer every augmentation stage hands to the next.
+ 
+ Move only so a matrix is never deep copied by accident, stages take a PatchView and
+ return a new PatchMatrix. Every time a matrix has to grow its buffer the global
+ allocation counter goes up, the augmenter reports it per run. Only PatchMatrix buffers
+ are counted, scratch vectors such as the sort order and Magnitude::applyOrder's held
+ row aren't, and sorting reorders rows in place so it adds nothing to the count.
+ */
+
+class PatchMatrix
+{
+public:
+    
+    PatchMatrix() = default;
+    PatchMatrix(int params) : numParams(params) {}
+    PatchMatrix(int rows, int params) : numParams(params) { resize(rows); }
+    
+    PatchMatrix(PatchMatrix&&) = default;
+    PatchMatrix& operator=(PatchMatrix&&) = default;
+    PatchMatrix(const PatchMatrix&) = delete;
+    PatchMatrix& operator=(const PatchMatrix&) = delete;
+    
+    int getNumRows() const { return numParams > 0 ? (int)(values.size() / (size_t)numParams) : 0; }
+    int getNumParams() const { return numParams; }
+    bool empty() const { return values.empty(); }
+    
+    void reserve(int rows)
+    {
+        if((size_t)rows * (size_t)numParams > values.capacity())
+            numAllocations++;
+        values.reserve((size_t)rows * (size_t)numParams);
+    }
+    
+    // new rows are zeroed
+    void resize(int rows)
+    {
+        reserve(rows);
+        values.resize((size_t)rows * (size_t)numParams, 0.0f);
+    }
+    
+    // row must hold getNumParams() floats
+    void addRow(const float* row)
+    {
+        if(values.size() + (size_t)numParams > values.capacity())
+            numAllocations++;
+        values.insert(values.end(), row, row + numParams);
+    }
+    
+    Span<float> getRow(int row) { return {values.data() + (size_t)row * (size_t)numParams, (size_t)numParams}; }
+    Span<const float> getRow(int row) const { return {values.data() + (size_t)row * (size_t)numParams, (size_t)numParams}; }
+    
+    float get(int row, int param) const { return values[(size_t)row * (size_t)numParams + (size_t)param]; }
+    void set(int row, int param, float value) { values[(size_t)row * (size_t)numParams + (size_t)param] = value; }
+    
+    float* data() { return values.data(); }
+    const float* data() const { return values.data(); }
+    
+    PatchView view() const { return {values.data(), getNumRows(), numParams}; }
+    operator PatchView() const { return view(); }
+    
+    // buffer allocations made by every PatchMatrix since the last reset
+    static int getNumAllocations() { return numAllocations.load(); }
+    static void resetNumAllocations() { numAllocations = 0; }
+    
+private:
+    
+    std::vector<float> values;
+    int numParams = 0;
+    
+    static inline std::atomic<int> numAllocations {0};
+};
@@ -0,0 +1,170 @@
+/*
+  ==============================================================================
+
+    TT_PatchStore.cpp
+    Created: 17 Oct 2026 4:20:51pm
+    Author:  Matt Twitchen
+
+  ==============================================================================
+*/
+
+#include "TT_PatchStore.h"
+
+void TT_PatchStore::reserve(int numRows)
+{
+    for(auto& column : columns)
+        column.reserve((size_t)numRows);
+    
+    tagMasks.reserve((size_t)numRows);
+    sourceFiles.reserve((size_t)numRows);
+}
+
+void TT_PatchStore::clear()
+{
+    for(auto& column : columns)
+        column.clear();
+    
+    tagMasks.clear();
+    sourceFiles.clear();
+}
+
+int TT_PatchStore::addRow(const float* values, juce::uint32 tagMask, int sourceFile)
+{
+    for(size_t i = 0 ; i < columns.size() ; i++)
+        columns[i].push_back(values[i]);
+    
+    tagMasks.push_back(tagMask);
+    sourceFiles.push_back(sourceFile);
+    
+    return getNumRows() - 1;
+}
+
+int TT_PatchStore::addRows(PatchView rows, juce::uint32 tagMask, int sourceFile)
+{
+    const size_t first = (size_t)getNumRows();
+    const size_t numRows = (size_t)rows.getNumRows();
+    const int numToCopy = juce::jmin(rows.getNumParams(), getNumParams());
+    
+    for(int k = 0 ; k < getNumParams() ; k++)
+    {
+        Column& column = columns[(size_t)k];
+        column.resize(first + numRows, 0.0f);
+        
+        if(k < numToCopy)
+        {
+            for(size_t i = 0 ; i < numRows ; i++)
+                column[first + i] = rows.get((int)i, k);
+        }
+    }
+    
+    tagMasks.resize(first + numRows, tagMask);
+    sourceFiles.resize(first + numRows, sourceFile);
+    
+    return (int)first;
+}
+
+void TT_PatchStore::setRow(int row, const float* values, juce::uint32 tagMask, int sourceFile)
+{
+    jassert(juce::isPositiveAndBelow(row, getNumRows()));
+    
+    for(size_t i = 0 ; i < columns.size() ; i++)
+        columns[i][(size_t)row] = values[i];
+    
+    tagMasks[(size_t)row] = tagMask;
+    sourceFiles[(size_t)row] = sourceFile;
+}
+
+void TT_PatchStore::copyRow(int row, float* destination) const
+{
+    for(size_t i = 0 ; i < columns.size() ; i++)
+        destination[i] = columns[i][(size_t)row];
+}
+
+std::vector<int> TT_PatchStore::getRowsWithTag(int tag) const
+{
+    std::vector<int> rows;
+    rows.reserve((size_t)countRowsWithTag(tag));
+    
+    const juce::uint32 bit = tagBit(tag);
+    for(size_t row = 0 ; row < tagMasks.size() ; row++)
+    {
+        if(tagMasks[row] & bit)
+            rows.push_back((int)row);
+    }
+    
+    return rows;
+}
+
+int TT_PatchStore::countRowsWithTag(int tag) const
+{
+    const juce::uint32 bit = tagBit(tag);
+    
+    int count = 0;
+    for(auto mask : tagMasks)
+        count += (mask & bit) != 0 ? 1 : 0;
+    
+    return count;
+}
+
+std::vector<int> TT_PatchStore::compact()
+{
+    std::vector<int> remap (tagMasks.size(), -1);
+    
+    size_t kept = 0;
+    for(size_t row = 0 ; row < tagMasks.size() ; row++)
+    {
+        if(tagMasks[row] == 0)
+            continue;
+        
+        if(kept != row)
+        {
+            for(auto& column : columns)
+                column[kept] = column[row];
+            
+            tagMasks[kept] = tagMasks[row];
+            sourceFiles[kept] = sourceFiles[row];
+        }
+        
+        remap[row] = (int)kept++;
+    }
+    
+    for(auto& column : columns)
+        column.resize(kept);
+    
+    tagMasks.resize(kept);
+    sourceFiles.resize(kept);
+    
+    return remap;
+}
+
+juce::ValueTree TT_PatchStore::createValueTree(const juce::Identifier& type,
+                                               const juce::Array<juce::Identifier>& parentTags,
+                                               const juce::Array<juce::Identifier>& patchTags,
+                                               const juce::Array<juce::Identifier>& paramIDs) const
+{
+    jassert(parentTags.size() == patchTags.size());
+    jassert(paramIDs.size() == getNumParams());
+    
+    juce::ValueTree typeTree {type};
+    
+    for(int tag = 0 ; tag < parentTags.size() ; tag++)
+    {
+        juce::ValueTree parentTree {parentTags[tag]};
+        
+        for(int row = 0 ; row < getNumRows() ; row++)
+        {
+            if(!hasTag(row, tag))
+                continue;
+            
+            juce::ValueTree child {patchTags[tag]};
+            for(int param = 0 ; param < paramIDs.size() ; param++)
+                child.setProperty(paramIDs[param], getValue(row, param), nullptr);
+            
+            parentTree.appendChild(child, nullptr);
+        }
+        
+        typeTree.appendChild(parentTree, nullptr);
+    }
+    
+    return typeTree;
+}
@@ -0,0 +1,96 @@
+/*
+  ==============================================================================
+
+    TT_PatchStore.h
+    Created: 17 Oct 2026 4:20:51pm
+    Author:  Matt Twitchen
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "TT_PatchMatrix.h"
+#include <new>
+#include <vector>
+
+// hands out 64 byte aligned blocks so each column starts on a cache line and can be loaded with aligned SIMD
+template <typename T>
+struct AlignedAllocator
+{
+    typedef T value_type;
+    static constexpr std::size_t alignment = 64;
+    
+    AlignedAllocator() = default;
+    template <typename U> AlignedAllocator(const AlignedAllocator<U>&) {}
+    
+    T* allocate(std::size_t n) { return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(alignment))); }
+    void deallocate(T* p, std::size_t) { ::operator delete(p, std::align_val_t(alignment)); }
+    
+    template <typename U> bool operator==(const AlignedAllocator<U>&) const { return true; }
+    template <typename U> bool operator!=(const AlignedAllocator<U>&) const { return false; }
+};
+
+typedef std::vector<float, AlignedAllocator<float>> Column;
+
+/*
+ Structure of arrays patch table, the dataset every stage reads and writes.
+ 
+ Each parameter is a contiguous column, a row is one patch. Rows carry a tag bitmask
+ (bit n = nth tag of the store's type) and the index of the library file they came
+ from, synthetic rows made by the augmenter use noSourceFile. Rows with an empty tag
+ mask are dead and get dropped by compact().
+ */
+
+class TT_PatchStore
+{
+public:
+    
+    static constexpr int noSourceFile = -1;
+    
+    TT_PatchStore(int numParameters) : columns((size_t)numParameters) {}
+    
+    static juce::uint32 tagBit(int tag) { return 1u << tag; }
+    
+    int getNumParams() const { return (int)columns.size(); }
+    int getNumRows() const { return (int)tagMasks.size(); }
+    
+    void reserve(int numRows);
+    void clear();
+    
+    // values must hold getNumParams() floats, returns the new row index
+    int addRow(const float* values, juce::uint32 tagMask, int sourceFile = noSourceFile);
+    // appends every row of a block with one resize per column, rows narrower than the store leave the remaining parameters at 0
+    int addRows(PatchView rows, juce::uint32 tagMask, int sourceFile = noSourceFile);
+    void setRow(int row, const float* values, juce::uint32 tagMask, int sourceFile = noSourceFile);
+    void copyRow(int row, float* destination) const;
+    
+    float getValue(int row, int param) const { return columns[(size_t)param][(size_t)row]; }
+    void setValue(int row, int param, float value) { columns[(size_t)param][(size_t)row] = value; }
+    
+    float* getColumn(int param) { return columns[(size_t)param].data(); }
+    const float* getColumn(int param) const { return columns[(size_t)param].data(); }
+    
+    juce::uint32 getTagMask(int row) const { return tagMasks[(size_t)row]; }
+    void setTagMask(int row, juce::uint32 tagMask) { tagMasks[(size_t)row] = tagMask; }
+    bool hasTag(int row, int tag) const { return (tagMasks[(size_t)row] & tagBit(tag)) != 0; }
+    int getSourceFile(int row) const { return sourceFiles[(size_t)row]; }
+    
+    std::vector<int> getRowsWithTag(int tag) const;
+    int countRowsWithTag(int tag) const;
+    
+    // drops dead rows, returns the new index of every old row or -1 if it was dropped
+    std::vector<int> compact();
+    
+    // GUI / debug export, one parent per tag holding a child node per row carrying that tag
+    juce::ValueTree createValueTree(const juce::Identifier& type,
+                                    const juce::Array<juce::Identifier>& parentTags,
+                                    const juce::Array<juce::Identifier>& patchTags,
+                                    const juce::Array<juce::Identifier>& paramIDs) const;
+    
+private:
+    
+    std::vector<Column> columns;
+    std::vector<juce::uint32> tagMasks;
+    std::vector<int> sourceFiles;
+};
@@ -10,6 +10,7 @@
 
 #pragma once
 #include "TT_Formatter.h"
+#include "TT_AugmentingBatchSource.h"
 
 using namespace tiny_dnn;
 
@@ -65,6 +66,21 @@ public:
         DBG("Training of TT_Spectral finished");
     }
     
+    // trains on batches the source augments on the fly, only the originals and one batch are ever held in memory
+    void train(TT_AugmentingBatchSource& source)
+    {
+        DBG("Training TT_Spectral on streamed batches ... ");
+        
+        nn.weight_init(weight_init::xavier());
+        nn.bias_init(weight_init::xavier());
+        
+        source.train(nn, opt, batchSize, epochs);
+        
+        nn.save("spectral-model");
+        
+        DBG("Training of TT_Spectral finished");
+    }
+    
     vec_t generate(vec_t input)
     {
         return nn.predict(input);
@@ -0,0 +1,251 @@
+/*
+  ==============================================================================
+
+    TT_Spline.h
+    Created: 22 Oct 2026 2:18:55pm
+    Author:  Matt Twitchen
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "TT_PatchMatrix.h"
+#include "TT_Lerp.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+/*
+ Cubic interpolation between consecutive patches of a tag.
+
+ Patches are treated as evenly spaced knots, patch i at i, the same way the linear kernel
+ steps through each segment in equal fractions, magnitudes only decide the order. Each
+ kind only differs in the tangent it gives every knot:
+
+ - PCHIP:       Fritsch-Carlson monotone cubic, never overshoots between two knots
+ - CATMULL_ROM: centred differences, smooth but can overshoot
+ - AKIMA:       weighted by how much the neighbouring slopes change, follows local
+                trends without ringing around outliers
+
+ Tangents become one cubic per segment and parameter, a + bt + ct^2 + dt^3, so every
+ generated value is one Horner evaluation and a clamp, at the same interior steps as the
+ linear kernel so no generated row is a copy of an original. Coefficients are fitted a block
+ of segments at a time into a small buffer and expanded straight away, each segment is
+ fitted once and its coefficients are still in cache when they're evaluated.
+ */
+
+enum InterpolationKind
+{
+    LINEAR = 0,
+    PCHIP,
+    CATMULL_ROM,
+    AKIMA
+};
+
+namespace Spline
+{
+    static constexpr int numCoefficients = 4;
+    
+    /*
+     Tangent of the N parameters at one knot from the four slopes around it,
+     window[0..3] = slopes i - 2 .. i + 1, slope j = patch j + 1 - patch j. Only the
+     first and last knots of a tag have isFirst / isLast set, the window is filled with
+     extrapolated slopes there for Akima. Choices are selects rather than branches so
+     each row of N vectorises.
+     */
+    template <int N>
+    static inline void computeTangent(InterpolationKind kind, const float (&window)[4][N], bool isFirst, bool isLast, float (&tangent)[N])
+    {
+        const float* s0 = window[0];
+        const float* s1 = window[1];
+        const float* s2 = window[2];
+        const float* s3 = window[3];
+        
+        if(kind == CATMULL_ROM)
+        {
+            for(int p = 0 ; p < N ; p++)
+                tangent[p] = isFirst ? s2[p] : isLast ? s1[p] : 0.5f * (s1[p] + s2[p]);
+        }
+        else if(kind == PCHIP && (isFirst || isLast))
+        {
+            // three point end tangents, kept monotone
+            const float* nearSlope = isFirst ? s2 : s1;
+            const float* farSlope = isFirst ? s3 : s0;
+            for(int p = 0 ; p < N ; p++)
+            {
+                const float t = 0.5f * (3.f * nearSlope[p] - farSlope[p]);
+                const bool overshoots = nearSlope[p] * farSlope[p] < 0.f && std::abs(t) > std::abs(3.f * nearSlope[p]);
+                tangent[p] = t * nearSlope[p] <= 0.f ? 0.f : overshoots ? 3.f * nearSlope[p] : t;
+            }
+        }
+        else if(kind == PCHIP)
+        {
+            // harmonic mean of the neighbouring slopes, flat at a local extremum. the sign test is a
+            // 0 / 1 factor, as a select GCC keeps it as a branch that mispredicts on every other knot
+            for(int p = 0 ; p < N ; p++)
+            {
+                const float product = s1[p] * s2[p];
+                const float positive = (float)(product > 0.f);
+                tangent[p] = positive * 2.f * product / (positive * (s1[p] + s2[p]) + (1.f - positive));
+            }
+        }
+        else
+        {
+            for(int p = 0 ; p < N ; p++)
+            {
+                const float weightBefore = std::abs(s3[p] - s2[p]);
+                const float weightAfter = std::abs(s1[p] - s0[p]);
+                const float totalWeight = weightBefore + weightAfter;
+                const float weighted = (weightBefore * s1[p] + weightAfter * s2[p]) / (totalWeight > 0.f ? totalWeight : 1.f);
+                tangent[p] = totalWeight > 0.f ? weighted : 0.5f * (s1[p] + s2[p]);
+            }
+        }
+    }
+    
+    static constexpr int blockSize = 128;
+    
+    /*
+     Cubics of segments [firstSegment, firstSegment + numSegments) for the first N
+     parameters of a tag, laid out segment by segment as {a[N], b[N], c[N], d[N]},
+     segment i runs from patch i to patch i + 1.
+     
+     One pass over the knots with a sliding window of slopes, a segment is written as
+     soon as the tangents at both of its ends are known.
+     */
+    template <int N>
+    static inline void computeCoefficients(PatchView tag, InterpolationKind kind, int firstSegment, int numSegments, float* coefficients)
+    {
+        const int numPatches = tag.getNumRows();
+        const int numSlopes = numPatches - 1;
+        constexpr int stride = numCoefficients * N;
+        jassert(firstSegment >= 0 && firstSegment + numSegments <= numPatches - 1);
+        
+        auto getInnerSlope = [&] (int j, float* slope)
+        {
+            const float* from = tag.getRow(j).data();
+            const float* to = tag.getRow(j + 1).data();
+            for(int p = 0 ; p < N ; p++)
+                slope[p] = to[p] - from[p];
+        };
+        
+        // slope j, extrapolated linearly for the two past either end of the tag, needs at least two slopes
+        auto getSlope = [&] (int j, float* slope)
+        {
+            if(j >= 0 && j < numSlopes)
+            {
+                getInnerSlope(j, slope);
+                return;
+            }
+            
+            const int distance = j < 0 ? -j : j - numSlopes + 1;
+            float nearSlope[N];
+            float farSlope[N];
+            getInnerSlope(j < 0 ? 0 : numSlopes - 1, nearSlope);
+            getInnerSlope(j < 0 ? 1 : numSlopes - 2, farSlope);
+            for(int p = 0 ; p < N ; p++)
+                slope[p] = (distance + 1) * nearSlope[p] - distance * farSlope[p];
+        };
+        
+        // knots up to the far end of the last segment
+        const int lastKnot = firstSegment + numSegments;
+        
+        float window[4][N];
+        if(numSlopes >= 2)
+        {
+            for(int w = 0 ; w < 4 ; w++)
+                getSlope(firstSegment - 2 + w, window[w]);
+        }
+        
+        float previous[N];
+        for(int i = firstSegment ; i <= lastKnot ; i++)
+        {
+            float tangent[N];
+            
+            if(numSlopes < 2)
+            {
+                // a single segment is a straight line
+                if(numSlopes == 1)
+                    getInnerSlope(0, tangent);
+                else
+                    std::fill(tangent, tangent + N, 0.f);
+            } else
+            {
+                if(i > firstSegment)
+                {
+                    for(int w = 0 ; w < 3 ; w++)
+                        std::copy(window[w + 1], window[w + 1] + N, window[w]);
+                    getSlope(i + 1, window[3]);
+                }
+                
+                computeTangent<N>(kind, window, i == 0, i == numPatches - 1, tangent);
+            }
+            
+            if(i > firstSegment)
+            {
+                const float* from = tag.getRow(i - 1).data();
+                const float* to = tag.getRow(i).data();
+                float* segment = coefficients + (size_t)((i - 1 - firstSegment) * stride);
+                
+                for(int p = 0 ; p < N ; p++)
+                {
+                    const float slope = to[p] - from[p];
+                    segment[p] = from[p];
+                    segment[N + p] = previous[p];
+                    segment[2 * N + p] = 3.f * slope - 2.f * previous[p] - tangent[p];
+                    segment[3 * N + p] = previous[p] + tangent[p] - 2.f * slope;
+                }
+            }
+            
+            for(int p = 0 ; p < N ; p++)
+                previous[p] = tangent[p];
+        }
+    }
+    
+    // same contract as Lerp::expandTag, kind must be one of the cubic kinds
+    template <int N>
+    static inline void expandTag(PatchView tag, InterpolationKind kind, int scaleFactor,
+                                 const float* minimums, const float* maximums, PatchMatrix& output)
+    {
+        const int numSegments = juce::jmax(0, tag.getNumRows() - 1);
+        jassert(kind != LINEAR);
+        jassert(scaleFactor >= 1);
+        jassert(output.getNumParams() == N && output.getNumRows() == numSegments * scaleFactor);
+        
+        const std::vector<float> steps = Lerp::getSteps(scaleFactor);
+        
+        float low[N];
+        float high[N];
+        std::copy(minimums, minimums + N, low);
+        std::copy(maximums, maximums + N, high);
+        
+        std::vector<float> coefficients ((size_t)(blockSize * numCoefficients * N));
+        
+        for(int firstSegment = 0 ; firstSegment < numSegments ; firstSegment += blockSize)
+        {
+            const int numBlockSegments = juce::jmin(blockSize, numSegments - firstSegment);
+            computeCoefficients<N>(tag, kind, firstSegment, numBlockSegments, coefficients.data());
+            
+            for(int i = 0 ; i < numBlockSegments ; i++)
+            {
+                // locals so the compiler knows the output can't alias them
+                const float* segment = coefficients.data() + (size_t)(i * numCoefficients * N);
+                float a[N], b[N], c[N], d[N];
+                for(int p = 0 ; p < N ; p++)
+                {
+                    a[p] = segment[p];
+                    b[p] = segment[N + p];
+                    c[p] = segment[2 * N + p];
+                    d[p] = segment[3 * N + p];
+                }
+                
+                float* out = output.getRow((firstSegment + i) * scaleFactor).data();
+                for(int j = 0 ; j < scaleFactor ; j++, out += N)
+                {
+                    const float t = steps[(size_t)j];
+                    for(int p = 0 ; p < N ; p++)
+                        out[p] = std::min(high[p], std::max(low[p], ((d[p] * t + c[p]) * t + b[p]) * t + a[p]));
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,306 @@
+/*
+  ==============================================================================
+
+    TT_Statistics.cpp
+    Created: 21 Oct 2026 10:05:19am
+    Author:  Matt Twitchen
+
+  ==============================================================================
+*/
+
+#include "TT_Statistics.h"
+#include <cmath>
+#include <numeric>
+
+TT_Statistics::Accumulator::Accumulator(int numParameters)
+    : numParams(numParameters),
+      means((size_t)numParameters, 0.0),
+      m2s((size_t)numParameters, 0.0),
+      mins((size_t)numParameters, 0.0),
+      maxs((size_t)numParameters, 0.0),
+      histograms((size_t)numParameters * numBins, 0),
+      sample(numParameters)
+{
+    sample.reserve(sampleSize);
+}
+
+void TT_Statistics::Accumulator::add(PatchView rows)
+{
+    const int numRows = rows.getNumRows();
+    if(numRows == 0)
+        return;
+    
+    jassert(rows.getNumParams() == numParams);
+    column.resize((size_t)numRows);
+    
+    const juce::int64 total = count + numRows;
+    
+    for(int k = 0 ; k < numParams ; k++)
+    {
+        for(int i = 0 ; i < numRows ; i++)
+            column[(size_t)i] = rows.get(i, k);
+        
+        // reduce the batch on its own, every loop is a plain sweep over the column, sums are
+        // kept in double so large batches don't lose the low bits
+        double sum = 0;
+        float low = column[0];
+        float high = column[0];
+        for(int i = 0 ; i < numRows ; i++)
+        {
+            sum += column[(size_t)i];
+            low = juce::jmin(low, column[(size_t)i]);
+            high = juce::jmax(high, column[(size_t)i]);
+        }
+        
+        const double batchMean = sum / numRows;
+        double batchM2 = 0;
+        for(int i = 0 ; i < numRows ; i++)
+            batchM2 += (column[(size_t)i] - batchMean) * (column[(size_t)i] - batchMean);
+        
+        // then merge it into the running moments
+        const double delta = batchMean - means[(size_t)k];
+        means[(size_t)k] += delta * numRows / total;
+        m2s[(size_t)k] += batchM2 + delta * delta * (double)count * numRows / total;
+        mins[(size_t)k] = count == 0 ? low : juce::jmin(mins[(size_t)k], (double)low);
+        maxs[(size_t)k] = count == 0 ? high : juce::jmax(maxs[(size_t)k], (double)high);
+        
+        juce::int64* histogram = histograms.data() + (size_t)k * numBins;
+        for(int i = 0 ; i < numRows ; i++)
+            histogram[juce::jlimit(0, numBins - 1, (int)(column[(size_t)i] * numBins))]++;
+    }
+    
+    // reservoir sample, the replacement slot is a hash of the row number so runs are repeatable
+    for(int i = 0 ; i < numRows ; i++)
+    {
+        const juce::int64 seen = count + i;
+        if(seen < sampleSize)
+        {
+            sample.addRow(rows.getRow(i).data());
+            continue;
+        }
+        
+        juce::uint64 hash = (juce::uint64)seen + 0x9E3779B97F4A7C15ull;
+        hash = (hash ^ (hash >> 30)) * 0xBF58476D1CE4E5B9ull;
+        hash = (hash ^ (hash >> 27)) * 0x94D049BB133111EBull;
+        hash ^= hash >> 31;
+        
+        const juce::uint64 slot = hash % (juce::uint64)(seen + 1);
+        if(slot < (juce::uint64)sampleSize)
+        {
+            Span<const float> row = rows.getRow(i);
+            std::copy(row.begin(), row.end(), sample.getRow((int)slot).begin());
+        }
+    }
+    
+    count = total;
+}
+
+TT_Statistics::Summary TT_Statistics::Accumulator::getSummary(int param) const
+{
+    Summary summary;
+    summary.count = count;
+    if(count == 0)
+        return summary;
+    
+    summary.mean = means[(size_t)param];
+    summary.variance = count > 1 ? m2s[(size_t)param] / (count - 1) : 0.0;
+    summary.min = mins[(size_t)param];
+    summary.max = maxs[(size_t)param];
+    
+    // linear within the bin the quantile falls in
+    const juce::int64* histogram = histograms.data() + (size_t)param * numBins;
+    juce::int64 below = 0;
+    int bin = 0;
+    for(int q = 0 ; q < numQuantiles ; q++)
+    {
+        const double target = quantileLevels[q] * count;
+        while(bin < numBins - 1 && below + histogram[bin] < target)
+            below += histogram[bin++];
+        
+        const double within = histogram[bin] > 0 ? (target - below) / histogram[bin] : 0.0;
+        summary.quantiles[q] = (float)((bin + juce::jlimit(0.0, 1.0, within)) / numBins);
+    }
+    
+    return summary;
+}
+
+float TT_Statistics::Accumulator::getKolmogorovSmirnov(const Accumulator& other, int param) const
+{
+    if(count == 0 || other.count == 0)
+        return 0;
+    
+    const juce::int64* a = histograms.data() + (size_t)param * numBins;
+    const juce::int64* b = other.histograms.data() + (size_t)param * numBins;
+    
+    juce::int64 cumulativeA = 0;
+    juce::int64 cumulativeB = 0;
+    double largestGap = 0;
+    for(int bin = 0 ; bin < numBins ; bin++)
+    {
+        cumulativeA += a[bin];
+        cumulativeB += b[bin];
+        largestGap = juce::jmax(largestGap, std::abs((double)cumulativeA / count - (double)cumulativeB / other.count));
+    }
+    
+    return (float)largestGap;
+}
+
+TT_Statistics::TagStatistics& TT_Statistics::getTag(const juce::String& tagName, int numParams)
+{
+    for(auto& tag : tags)
+    {
+        if(tag.name == tagName)
+            return tag;
+    }
+    
+    tags.emplace_back(tagName, numParams);
+    return tags.back();
+}
+
+const TT_Statistics::TagStatistics* TT_Statistics::findTag(const juce::String& tagName) const
+{
+    for(auto& tag : tags)
+    {
+        if(tag.name == tagName)
+            return &tag;
+    }
+    return nullptr;
+}
+
+double TT_Statistics::getMaximumMeanDiscrepancy(const juce::String& tagName, int numThreads) const
+{
+    const TagStatistics* tag = findTag(tagName);
+    if(tag == nullptr)
+        return 0;
+    
+    const PatchMatrix& x = tag->original.getSample();
+    const PatchMatrix& y = tag->augmented.getSample();
+    const int numX = x.getNumRows();
+    const int numY = y.getNumRows();
+    const int numParams = x.getNumParams();
+    
+    if(numX < 2 || numY < 2)
+        return 0;
+    
+    // bandwidth from the mean squared distance between two random originals, 2 * summed variance
+    double summedVariance = 0;
+    for(int k = 0 ; k < numParams ; k++)
+        summedVariance += tag->original.getSummary(k).variance;
+    
+    const float gamma = (float)(1.0 / juce::jmax(1.0e-6, 2.0 * summedVariance));
+    
+    auto kernelSum = [&] (const PatchMatrix& a, const PatchMatrix& b, int row, bool skipSame)
+    {
+        Span<const float> first = a.getRow(row);
+        double sum = 0;
+        for(int j = 0 ; j < b.getNumRows() ; j++)
+        {
+            if(skipSame && j == row)
+                continue;
+            
+            Span<const float> second = b.getRow(j);
+            float distanceSqr = 0;
+            for(int k = 0 ; k < numParams ; k++)
+                distanceSqr += (first[(size_t)k] - second[(size_t)k]) * (first[(size_t)k] - second[(size_t)k]);
+            
+            sum += std::exp(-gamma * distanceSqr);
+        }
+        return sum;
+    };
+    
+    // one task per row of x and of y, partial sums are added in row order so the result doesn't depend on scheduling
+    std::vector<double> xx ((size_t)numX), xy ((size_t)numX), yy ((size_t)numY);
+    Parallel::forEachTask(numX + numY, numThreads, [&] (int task)
+    {
+        if(task < numX)
+        {
+            xx[(size_t)task] = kernelSum(x, x, task, true);
+            xy[(size_t)task] = kernelSum(x, y, task, false);
+        } else
+        {
+            yy[(size_t)(task - numX)] = kernelSum(y, y, task - numX, true);
+        }
+    });
+    
+    const double sumXX = std::accumulate(xx.begin(), xx.end(), 0.0);
+    const double sumXY = std::accumulate(xy.begin(), xy.end(), 0.0);
+    const double sumYY = std::accumulate(yy.begin(), yy.end(), 0.0);
+    
+    return sumXX / ((double)numX * (numX - 1))
+         + sumYY / ((double)numY * (numY - 1))
+         - 2.0 * sumXY / ((double)numX * numY);
+}
+
+juce::var TT_Statistics::createSummary(const Summary& summary)
+{
+    juce::var result (new juce::DynamicObject());
+    juce::DynamicObject* object = result.getDynamicObject();
+    
+    object->setProperty("count", summary.count);
+    object->setProperty("mean", summary.mean);
+    object->setProperty("variance", summary.variance);
+    object->setProperty("min", summary.min);
+    object->setProperty("max", summary.max);
+    
+    juce::var quantiles;
+    for(int q = 0 ; q < numQuantiles ; q++)
+        quantiles.append(summary.quantiles[q]);
+    object->setProperty("quantiles", quantiles);
+    
+    return result;
+}
+
+juce::var TT_Statistics::createReport(int numThreads) const
+{
+    juce::var levels;
+    for(int q = 0 ; q < numQuantiles ; q++)
+        levels.append(quantileLevels[q]);
+    
+    juce::var tagList;
+    for(auto& tag : tags)
+    {
+        juce::var original;
+        juce::var augmented;
+        juce::var ks;
+        
+        for(int k = 0 ; k < tag.original.getNumParams() ; k++)
+        {
+            original.append(createSummary(tag.original.getSummary(k)));
+            augmented.append(createSummary(tag.augmented.getSummary(k)));
+            ks.append(tag.original.getKolmogorovSmirnov(tag.augmented, k));
+        }
+        
+        juce::var entry (new juce::DynamicObject());
+        juce::DynamicObject* object = entry.getDynamicObject();
+        object->setProperty("tag", tag.name);
+        object->setProperty("original", original);
+        object->setProperty("augmented", augmented);
+        object->setProperty("ks", ks);
+        object->setProperty("mmd2", getMaximumMeanDiscrepancy(tag.name, numThreads));
+        tagList.append(entry);
+    }
+    
+    juce::var report (new juce::DynamicObject());
+    report.getDynamicObject()->setProperty("quantileLevels", levels);
+    report.getDynamicObject()->setProperty("tags", tagList);
+    
+    return report;
+}
+
+bool TT_Statistics::writeReport(const juce::File& file, int numThreads) const
+{
+    return file.replaceWithText(juce::JSON::toString(createReport(numThreads)));
+}
+
+void TT_Statistics::logSummary() const
+{
+    for(auto& tag : tags)
+    {
+        float largestKS = 0;
+        for(int k = 0 ; k < tag.original.getNumParams() ; k++)
+            largestKS = juce::jmax(largestKS, tag.original.getKolmogorovSmirnov(tag.augmented, k));
+        
+        DBG(tag.name << ": " << (int)tag.original.getCount() << " original, " << (int)tag.augmented.getCount()
+            << " augmented, largest KS = " << largestKS);
+    }
+}
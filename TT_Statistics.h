@@ -0,0 +1,115 @@
+/*
+  ==============================================================================
+
+    TT_Statistics.h
+    Created: 21 Oct 2026 10:05:19am
+    Author:  Matt Twitchen
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "TT_Parallel.h"
+#include "TT_PatchMatrix.h"
+
+/*
+ Streaming statistics of the original and augmented data of every tag.
+ 
+ Rows are added batch by batch and never kept, apart from a small fixed size reservoir
+ sample used for MMD. Per parameter mean / variance / min / max are accumulated with
+ Welford's method, each batch is reduced column by column and merged in (Chan et al.),
+ quantiles and the KS distance come from a fixed histogram over [0, 1], the range every
+ parameter is normalised to.
+ 
+ The report holds, per tag, a summary of every parameter for both sets, the KS
+ statistic between them per parameter, and the MMD between the full vectors with an
+ RBF kernel.
+ */
+
+class TT_Statistics
+{
+public:
+    
+    static constexpr int numQuantiles = 5;
+    static constexpr float quantileLevels[numQuantiles] = {0.05f, 0.25f, 0.5f, 0.75f, 0.95f};
+    
+    struct Summary
+    {
+        juce::int64 count = 0;
+        double mean = 0;
+        double variance = 0;
+        double min = 0;
+        double max = 0;
+        float quantiles[numQuantiles] = {};
+    };
+    
+    // one stream of rows, the originals or the augmented rows of a tag
+    class Accumulator
+    {
+    public:
+        
+        Accumulator(int numParameters);
+        
+        void add(PatchView rows);
+        
+        int getNumParams() const { return numParams; }
+        juce::int64 getCount() const { return count; }
+        Summary getSummary(int param) const;
+        
+        // largest gap between the two empirical CDFs, to histogram resolution
+        float getKolmogorovSmirnov(const Accumulator& other, int param) const;
+        
+        const PatchMatrix& getSample() const { return sample; }
+        
+    private:
+        
+        int numParams;
+        juce::int64 count = 0;
+        
+        std::vector<double> means;
+        std::vector<double> m2s;
+        std::vector<double> mins;
+        std::vector<double> maxs;
+        std::vector<juce::int64> histograms; // numParams x numBins
+        
+        PatchMatrix sample;
+        std::vector<float> column; // scratch
+    };
+    
+    static constexpr int numBins = 1024;
+    static constexpr int sampleSize = 512;
+    
+    TT_Statistics() {}
+    
+    void reset() { tags.clear(); }
+    
+    void addOriginal(const juce::String& tagName, PatchView rows) { getTag(tagName, rows.getNumParams()).original.add(rows); }
+    void addAugmented(const juce::String& tagName, PatchView rows) { getTag(tagName, rows.getNumParams()).augmented.add(rows); }
+    
+    // unbiased MMD^2 between the reservoir samples of a tag, kernel rows are split across numThreads workers
+    double getMaximumMeanDiscrepancy(const juce::String& tagName, int numThreads) const;
+    
+    // machine readable report of every tag, see the class comment
+    juce::var createReport(int numThreads) const;
+    bool writeReport(const juce::File& file, int numThreads) const;
+    
+    // one DBG line per tag
+    void logSummary() const;
+    
+private:
+    
+    struct TagStatistics
+    {
+        TagStatistics(const juce::String& tagName, int numParams) : name(tagName), original(numParams), augmented(numParams) {}
+        
+        juce::String name;
+        Accumulator original;
+        Accumulator augmented;
+    };
+    
+    TagStatistics& getTag(const juce::String& tagName, int numParams);
+    const TagStatistics* findTag(const juce::String& tagName) const;
+    static juce::var createSummary(const Summary& summary);
+    
+    std::vector<TagStatistics> tags; // in the order they were first seen
+};
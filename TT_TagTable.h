@@ -0,0 +1,208 @@
+/*
+  ==============================================================================
+
+    TT_TagTable.h
+    Created: 18 Oct 2026 1:35:40pm
+    Author:  Matt Twitchen
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include <string_view>
+#include "TT_DataNodes.h"
+
+/*
+ Interned tag lookup for the metadata timbres / types attributes.
+ 
+ Attributes are split into words on , ; | / and whitespace and each word is normalised
+ (letters and digits only, lower case), so "long_release" and "LongRelease" map to the
+ same entry. Multi word tags are matched by trying each word together with the next
+ one first when only whitespace separates them, so "Long Release" is one tag while
+ "Bright Dark" is two. Tokens are looked up in a perfect hash table built at compile
+ time, only whole tokens match, "Super Bright" is Bright but "SuperBright" isn't.
+ 
+ Bits follow the patchTags arrays in TT_DataNodes.h, spectral and temporal tags each
+ get their own mask, a static_assert keeps the table in step with their names.
+ */
+
+namespace TagTable
+{
+    struct Entry
+    {
+        std::string_view name; // normalised
+        bool isTemporal;
+        int tag; // index into Spectral / Temporal patchTags
+    };
+    
+    static constexpr Entry entries[] = {{"bright", false, 0},
+                                        {"dark", false, 1},
+                                        {"resonant", false, 2},
+                                        {"soft", false, 3},
+                                        {"pluck", true, 0},
+                                        {"longrelease", true, 1},
+                                        {"swell", true, 2},
+                                        {"short", true, 3}};
+    
+    static constexpr int numEntries = (int)(sizeof(entries) / sizeof(entries[0]));
+    static constexpr int tableSize = 16;
+    static constexpr juce::uint32 hashSeed = 2166136261u + 7u; // picked so the entries don't collide
+    
+    static constexpr bool isTokenChar(char c)
+    {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9');
+    }
+    
+    static constexpr char toLower(char c)
+    {
+        return (c >= 'A' && c <= 'Z') ? (char)(c - 'A' + 'a') : c;
+    }
+    
+    // FNV-1a over the normalised characters of a token
+    static constexpr juce::uint32 hashToken(std::string_view token)
+    {
+        juce::uint32 hash = hashSeed;
+        for(char c : token)
+        {
+            if(!isTokenChar(c))
+                continue;
+            
+            hash ^= (juce::uint8)toLower(c);
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+    
+    // compares a raw token against a normalised entry name
+    static constexpr bool tokenMatches(std::string_view token, std::string_view name)
+    {
+        size_t n = 0;
+        for(char c : token)
+        {
+            if(!isTokenChar(c))
+                continue;
+            
+            if(n >= name.size() || toLower(c) != name[n])
+                return false;
+            n++;
+        }
+        return n == name.size();
+    }
+    
+    struct Slots
+    {
+        int entry[tableSize];
+    };
+    
+    static constexpr Slots buildSlots()
+    {
+        Slots slots {};
+        for(int i = 0 ; i < tableSize ; i++)
+            slots.entry[i] = -1;
+        
+        for(int i = 0 ; i < numEntries ; i++)
+            slots.entry[hashToken(entries[i].name) % tableSize] = i;
+        
+        return slots;
+    }
+    
+    static constexpr bool isPerfect()
+    {
+        Slots slots = buildSlots();
+        int filled = 0;
+        for(int i = 0 ; i < tableSize ; i++)
+            filled += slots.entry[i] >= 0 ? 1 : 0;
+        
+        return filled == numEntries;
+    }
+    
+    static_assert(isPerfect(), "tag names collide, change hashSeed or tableSize");
+    
+    static constexpr bool matchesPatchTags()
+    {
+        using namespace DataNodes::TagNodes;
+        
+        bool found[2][8] = {};
+        for(int i = 0 ; i < numEntries ; i++)
+        {
+            const Entry& entry = entries[i];
+            const int numTags = entry.isTemporal ? numTemporalTags : numSpectralTags;
+            if(entry.tag < 0 || entry.tag >= numTags)
+                return false;
+            
+            const char* tagName = entry.isTemporal ? temporalTagNames[entry.tag] : spectralTagNames[entry.tag];
+            if(!tokenMatches(tagName, entry.name))
+                return false;
+            
+            found[entry.isTemporal ? 1 : 0][entry.tag] = true;
+        }
+        
+        for(int tag = 0 ; tag < numSpectralTags ; tag++)
+        {
+            if(!found[0][tag])
+                return false;
+        }
+        
+        for(int tag = 0 ; tag < numTemporalTags ; tag++)
+        {
+            if(!found[1][tag])
+                return false;
+        }
+        
+        return true;
+    }
+    
+    static_assert(DataNodes::TagNodes::numSpectralTags <= 8 && DataNodes::TagNodes::numTemporalTags <= 8, "tag masks are 8 bits per type in the patch cache");
+    static_assert(matchesPatchTags(), "every tag needs exactly the entry named after it at its patchTags index");
+    
+    static constexpr Slots slots = buildSlots();
+    
+    // entry for a token, nullptr if it isn't a tag
+    static constexpr const Entry* find(std::string_view token)
+    {
+        const int entry = slots.entry[hashToken(token) % tableSize];
+        if(entry < 0 || !tokenMatches(token, entries[entry].name))
+            return nullptr;
+        
+        return &entries[entry];
+    }
+    
+    static constexpr std::string_view separators = ",;|/ \t\r\n";
+    static constexpr std::string_view whitespace = " \t\r\n";
+    
+    // ors the bit of every matching tag in an attribute into the mask for its type
+    static inline void classify(std::string_view attribute, bool temporal, juce::uint32& mask)
+    {
+        auto findWordEnd = [attribute] (size_t start)
+        {
+            const size_t end = attribute.find_first_of(separators, start);
+            return end == std::string_view::npos ? attribute.size() : end;
+        };
+        
+        size_t start = attribute.find_first_not_of(separators);
+        while(start != std::string_view::npos)
+        {
+            size_t end = findWordEnd(start);
+            const Entry* entry = nullptr;
+            
+            // a word and the next one as a single tag, only across whitespace
+            const size_t next = attribute.find_first_not_of(whitespace, end);
+            if(next != std::string_view::npos && next > end && separators.find(attribute[next]) == std::string_view::npos)
+            {
+                const size_t nextEnd = findWordEnd(next);
+                entry = find(attribute.substr(start, nextEnd - start));
+                if(entry != nullptr)
+                    end = nextEnd;
+            }
+            
+            if(entry == nullptr)
+                entry = find(attribute.substr(start, end - start));
+            
+            if(entry != nullptr && entry->isTemporal == temporal)
+                mask |= 1u << entry->tag;
+            
+            start = attribute.find_first_not_of(separators, end);
+        }
+    }
+}
@@ -0,0 +1,256 @@
+/*
+  ==============================================================================
+
+    TT_XmlStreamReader.cpp
+    Created: 17 Oct 2026 11:02:37am
+    Author:  Matt Twitchen
+
+  ==============================================================================
+*/
+
+#include "TT_XmlStreamReader.h"
+#include <JuceHeader.h>
+#include <cstring>
+
+static inline bool isXmlWhitespace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+TT_XmlStreamReader::TT_XmlStreamReader(const char* data, size_t size) : position(data), end(data + size)
+{
+    
+}
+
+TT_XmlStreamReader::Event TT_XmlStreamReader::next()
+{
+    if(pendingEnd)
+    {
+        pendingEnd = false;
+        depth = --openElements;
+        return EndElement;
+    }
+    
+    for(;;)
+    {
+        const char* open = static_cast<const char*>(std::memchr(position, '<', (size_t)(end - position)));
+        if(open == nullptr)
+            return openElements == 0 ? EndOfDocument : Error;
+        
+        position = open + 1;
+        std::string_view rest (position, (size_t)(end - position));
+        
+        if(rest.substr(0, 3) == "!--")
+        {
+            if(!skipPast("-->"))
+                return Error;
+        } else if(rest.substr(0, 8) == "![CDATA[")
+        {
+            if(!skipPast("]]>"))
+                return Error;
+        } else if(rest.substr(0, 1) == "?")
+        {
+            if(!skipPast("?>"))
+                return Error;
+        } else if(rest.substr(0, 1) == "!")
+        {
+            if(!skipPast(">"))
+                return Error;
+        } else if(rest.substr(0, 1) == "/")
+        {
+            const char* nameStart = position + 1;
+            const char* close = static_cast<const char*>(std::memchr(nameStart, '>', (size_t)(end - nameStart)));
+            if(close == nullptr || openElements == 0)
+                return Error;
+            
+            const char* nameEnd = nameStart;
+            while(nameEnd < close && !isXmlWhitespace(*nameEnd))
+                nameEnd++;
+            
+            tagName = std::string_view(nameStart, (size_t)(nameEnd - nameStart));
+            attributes = {};
+            position = close + 1;
+            depth = --openElements;
+            return EndElement;
+        } else
+        {
+            const char* nameEnd = position;
+            while(nameEnd < end && !isXmlWhitespace(*nameEnd) && *nameEnd != '/' && *nameEnd != '>')
+                nameEnd++;
+            
+            // find the end of the tag, quoted attribute values can contain '>'
+            const char* close = nameEnd;
+            char quote = 0;
+            while(close < end)
+            {
+                if(quote != 0)
+                {
+                    if(*close == quote)
+                        quote = 0;
+                } else if(*close == '"' || *close == '\'')
+                {
+                    quote = *close;
+                } else if(*close == '>')
+                {
+                    break;
+                }
+                close++;
+            }
+            
+            if(close == end || nameEnd == position)
+                return Error;
+            
+            const bool selfClosing = *(close - 1) == '/';
+            
+            tagName = std::string_view(position, (size_t)(nameEnd - position));
+            attributes = std::string_view(nameEnd, (size_t)((selfClosing ? close - 1 : close) - nameEnd));
+            position = close + 1;
+            
+            depth = openElements++;
+            pendingEnd = selfClosing;
+            return StartElement;
+        }
+    }
+}
+
+std::string_view TT_XmlStreamReader::getAttribute(std::string_view name) const
+{
+    std::string_view value;
+    findAttribute(name, value);
+    return value.find('&') == std::string_view::npos ? value : decodeEntities(value);
+}
+
+float TT_XmlStreamReader::getFloatAttribute(std::string_view name, float defaultValue) const
+{
+    std::string_view value;
+    if(!findAttribute(name, value) || value.empty())
+        return defaultValue;
+    
+    // values are short numbers, copy into a terminated buffer for JUCE's parser, strtod
+    // would follow the locale and stop at the '.' wherever the decimal separator is ','
+    char buffer[64];
+    const size_t length = value.size() < sizeof(buffer) - 1 ? value.size() : sizeof(buffer) - 1;
+    std::memcpy(buffer, value.data(), length);
+    buffer[length] = 0;
+    
+    juce::CharPointer_ASCII text (buffer);
+    return (float)juce::CharacterFunctions::readDoubleValue(text);
+}
+
+bool TT_XmlStreamReader::hasAttribute(std::string_view name) const
+{
+    std::string_view value;
+    return findAttribute(name, value);
+}
+
+bool TT_XmlStreamReader::findAttribute(std::string_view name, std::string_view& value) const
+{
+    size_t i = 0;
+    while(i < attributes.size())
+    {
+        while(i < attributes.size() && isXmlWhitespace(attributes[i]))
+            i++;
+        
+        const size_t nameStart = i;
+        while(i < attributes.size() && attributes[i] != '=' && !isXmlWhitespace(attributes[i]))
+            i++;
+        
+        std::string_view attributeName = attributes.substr(nameStart, i - nameStart);
+        
+        while(i < attributes.size() && (isXmlWhitespace(attributes[i]) || attributes[i] == '='))
+            i++;
+        
+        if(i >= attributes.size())
+            return false;
+        
+        const char quote = attributes[i];
+        if(quote != '"' && quote != '\'')
+            return false;
+        
+        const size_t valueStart = ++i;
+        while(i < attributes.size() && attributes[i] != quote)
+            i++;
+        
+        if(attributeName == name)
+        {
+            value = attributes.substr(valueStart, i - valueStart);
+            return true;
+        }
+        
+        i++;
+    }
+    
+    return false;
+}
+
+std::string_view TT_XmlStreamReader::decodeEntities(std::string_view value) const
+{
+    decoded.clear();
+    
+    size_t i = 0;
+    while(i < value.size())
+    {
+        const size_t semicolon = value[i] == '&' ? value.find(';', i) : std::string_view::npos;
+        if(semicolon == std::string_view::npos)
+        {
+            decoded += value[i++];
+            continue;
+        }
+        
+        const std::string_view entity = value.substr(i + 1, semicolon - i - 1);
+        
+        juce::uint32 codePoint = 0;
+        if(entity == "amp")
+            codePoint = '&';
+        else if(entity == "lt")
+            codePoint = '<';
+        else if(entity == "gt")
+            codePoint = '>';
+        else if(entity == "quot")
+            codePoint = '"';
+        else if(entity == "apos")
+            codePoint = '\'';
+        else if(entity.size() > 1 && entity[0] == '#')
+        {
+            const bool isHex = entity[1] == 'x' || entity[1] == 'X';
+            for(size_t j = isHex ? 2 : 1 ; j < entity.size() ; j++)
+            {
+                const int digit = isHex ? juce::CharacterFunctions::getHexDigitValue((juce::juce_wchar)entity[j])
+                                        : (entity[j] >= '0' && entity[j] <= '9' ? entity[j] - '0' : -1);
+                if(digit < 0 || codePoint > 0x10ffff)
+                {
+                    codePoint = 0;
+                    break;
+                }
+                codePoint = codePoint * (isHex ? 16 : 10) + (juce::uint32)digit;
+            }
+        }
+        
+        // anything unknown is kept as it is, the same as the DOM
+        if(codePoint == 0 || codePoint > 0x10ffff)
+        {
+            decoded += value[i++];
+            continue;
+        }
+        
+        char utf8[4];
+        const size_t numBytes = juce::CharPointer_UTF8::getBytesRequiredFor((juce::juce_wchar)codePoint);
+        juce::CharPointer_UTF8 writer (utf8);
+        writer.write((juce::juce_wchar)codePoint);
+        decoded.append(utf8, numBytes);
+        i = semicolon + 1;
+    }
+    
+    return decoded;
+}
+
+bool TT_XmlStreamReader::skipPast(std::string_view terminator)
+{
+    std::string_view rest (position, (size_t)(end - position));
+    const size_t found = rest.find(terminator);
+    if(found == std::string_view::npos)
+        return false;
+    
+    position += found + terminator.size();
+    return true;
+}
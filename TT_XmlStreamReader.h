@@ -0,0 +1,71 @@
+/*
+  ==============================================================================
+
+    TT_XmlStreamReader.h
+    Created: 17 Oct 2026 11:02:37am
+    Author:  Matt Twitchen
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+/*
+ Forward-only pull parser for the MM2 patch files.
+ 
+ Walks the raw bytes once and reports start/end element events, attributes are read
+ straight out of the buffer so nothing is allocated and no DOM is built. Values that
+ contain entity references are decoded the way juce::XmlDocument decodes them. Text
+ content, comments, processing instructions and doctype declarations are skipped.
+ */
+
+class TT_XmlStreamReader
+{
+public:
+    
+    enum Event
+    {
+        StartElement = 0,
+        EndElement,
+        EndOfDocument,
+        Error
+    };
+    
+    TT_XmlStreamReader(const char* data, size_t size);
+    
+    // advances to the next element event
+    Event next();
+    
+    // name of the element the last event belongs to
+    std::string_view getTagName() const { return tagName; }
+    // number of open ancestors of the current element, the root element is at depth 0
+    int getDepth() const { return depth; }
+    
+    // decoded attribute value of the current start element, empty if it's missing,
+    // only valid until the next call when the value had to be decoded
+    std::string_view getAttribute(std::string_view name) const;
+    // parsed in the C locale like juce::String::getDoubleValue, whatever the user's locale is
+    float getFloatAttribute(std::string_view name, float defaultValue = 0.f) const;
+    bool hasAttribute(std::string_view name) const;
+    
+private:
+    
+    bool findAttribute(std::string_view name, std::string_view& value) const;
+    bool skipPast(std::string_view terminator);
+    std::string_view decodeEntities(std::string_view value) const;
+    
+    const char* position;
+    const char* end;
+    
+    std::string_view tagName;
+    std::string_view attributes; // raw attribute text of the current start element
+    
+    int depth = -1;
+    int openElements = 0;
+    bool pendingEnd = false; // self closing elements report their end on the following call
+    
+    mutable std::string decoded; // reused by every value with an entity in it
+};